@@ -0,0 +1,236 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "fecs/huge_page_vector.hpp"
+#include "fecs/reduce.hpp"
+#include "fecs/world.hpp"
+
+/**
+ * Micro-benchmarks for the stores and for mapEntities.
+ * Every result is reported in nanoseconds per entity, so runs with different entity counts are comparable.
+ *
+ * Usage: bench [entity count]
+ */
+
+namespace {
+  // Keeps the optimizer from throwing away work whose result we never look at.
+  volatile std::int64_t sink;
+
+  std::size_t entityCount = 1000000;
+
+  // Reports the best of several runs of f; setup runs before each one and is not timed.
+  template<typename Setup, typename F>
+  void measure(const std::string& name, std::size_t perRun, Setup setup, F f) {
+    constexpr int runs = 5;
+    double best = 0;
+    for(int run = 0; run < runs; ++run) {
+      setup();
+      const auto start = std::chrono::steady_clock::now();
+      f();
+      const auto end = std::chrono::steady_clock::now();
+      const double ns = std::chrono::duration<double, std::nano>(end - start).count() / perRun;
+      if(run == 0 || ns < best) {
+        best = ns;
+      }
+    }
+    std::cout << std::left << std::setw(56) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << best
+              << " ns/entity\n";
+  }
+
+  template<typename F>
+  void measure(const std::string& name, std::size_t perRun, F f) {
+    measure(name, perRun, [] {}, f);
+  }
+
+  template<typename Store>
+  void benchStore(const std::string& name) {
+    Store store;
+    measure(name + " addComponent", entityCount, [&] {
+      store = Store{};
+      for(fecs::EntityId i = 0; i < entityCount; ++i) {
+        store.addComponent(i, static_cast<int>(i));
+      }
+    });
+    measure(name + " getUnsafe", entityCount, [&] {
+      std::int64_t sum = 0;
+      for(fecs::EntityId i = 0; i < entityCount; ++i) {
+        sum += store.getUnsafe(i);
+      }
+      sink = sum;
+    });
+    measure(name + " getSafe", entityCount, [&] {
+      std::int64_t sum = 0;
+      for(fecs::EntityId i = 0; i < entityCount; ++i) {
+        sum += store.getSafe(i).value_or(0);
+      }
+      sink = sum;
+    });
+    Store copy;
+    measure(name + " removeComponent", entityCount, [&] { copy = store; }, [&] {
+      for(fecs::EntityId i = 0; i < entityCount; ++i) {
+        copy.removeComponent(i);
+      }
+    });
+  }
+
+  struct A { float v; };
+  struct B { float v; };
+  struct C { float v; };
+  struct D { float v; };
+
+  using BenchWorld = fecs::world<
+    fecs::vector_store<A>,
+    fecs::vector_store<B>,
+    fecs::vector_store<C>,
+    fecs::vector_store<D>
+  >;
+
+  // Every entity gets A; B, C and D are present on one in every `stride` entities.
+  BenchWorld makeWorld(std::size_t stride) {
+    BenchWorld w;
+    for(std::size_t i = 0; i < entityCount; ++i) {
+      const auto e = w.newEntity();
+      const auto v = static_cast<float>(i);
+      w.addComponent(e, A{v});
+      if(i % stride == 0) {
+        w.addComponent(e, B{v});
+        w.addComponent(e, C{v});
+        w.addComponent(e, D{v});
+      }
+    }
+    return w;
+  }
+
+  void benchMapping(std::size_t stride) {
+    auto w = makeWorld(stride);
+    const auto density = " (1/" + std::to_string(stride) + " dense)";
+
+    measure("mapEntities<A> -> A" + density, entityCount, [&] {
+      fecs::mapEntities<A>(w, [](A a) -> A { return {a.v + 1}; });
+    });
+    measure("mapEntities<A, B> -> A" + density, entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> A { return {a.v + b.v}; });
+    });
+    measure("mapEntities<A, B, C> -> A" + density, entityCount, [&] {
+      fecs::mapEntities<A, B, C>(w, [](A a, B b, C c) -> A { return {a.v + b.v * c.v}; });
+    });
+    measure("mapEntities<A, B, C, D> -> A" + density, entityCount, [&] {
+      fecs::mapEntities<A, B, C, D>(w, [](A a, B b, C c, D d) -> A {
+        return {a.v + b.v * c.v - d.v};
+      });
+    });
+    measure("mapEntities<A, B> -> void" + density, entityCount, [&] {
+      double sum = 0;
+      fecs::mapEntities<A, B>(w, [&](A a, B b) -> void { sum += a.v * b.v; });
+      sink = static_cast<std::int64_t>(sum);
+    });
+  }
+
+  void benchResultTypes() {
+    auto w = makeWorld(2);
+
+    measure("mapEntities<A, B> -> A", entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> A { return {a.v + b.v}; });
+    });
+    measure("mapEntities<entity, A, B> -> A", entityCount, [&] {
+      fecs::mapEntities<fecs::entity, A, B>(w, [](fecs::entity e, A a, B b) -> A {
+        return {a.v + b.v + static_cast<float>(e.id & 1)};
+      });
+    });
+    measure("mapEntities<A, B> -> std::optional<A>", entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> std::optional<A> {
+        return A{a.v + b.v};
+      });
+    });
+    measure("mapEntities<A, B> -> std::tuple<A, B>", entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> std::tuple<A, B> {
+        return {A{a.v + 1}, B{b.v + 1}};
+      });
+    });
+    measure("mapEntities<A, B> -> std::variant<A, B>", entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> std::variant<A, B> {
+        if(a.v > b.v) {
+          return A{a.v - 1};
+        }
+        return B{b.v - 1};
+      });
+    });
+  }
+
+  void benchHandWritten() {
+    std::vector<std::optional<A>> as(entityCount);
+    std::vector<std::optional<B>> bs(entityCount);
+    for(std::size_t i = 0; i < entityCount; ++i) {
+      as[i] = A{static_cast<float>(i)};
+      if(i % 2 == 0) {
+        bs[i] = B{static_cast<float>(i)};
+      }
+    }
+    measure("hand-written loop A += B (1/2 dense)", entityCount, [&] {
+      for(std::size_t i = 0; i < entityCount; ++i) {
+        if(as[i] && bs[i]) {
+          as[i]->v += bs[i]->v;
+        }
+      }
+    });
+
+    auto w = makeWorld(2);
+    measure("mapEntities<A, B> -> A (1/2 dense)", entityCount, [&] {
+      fecs::mapEntities<A, B>(w, [](A a, B b) -> A { return {a.v + b.v}; });
+    });
+  }
+
+  void benchReduce() {
+    const auto w = makeWorld(2);
+    measure("mapEntities<A, B> -> void, summing (1/2 dense)", entityCount, [&] {
+      double sum = 0;
+      fecs::mapEntities<A, B>(w, [&](A a, B b) -> void { sum += a.v * b.v; });
+      sink = static_cast<std::int64_t>(sum);
+    });
+    measure("reduce<A, B> (1/2 dense)", entityCount, [&] {
+      const auto sum = fecs::reduce<A, B>(
+          w,
+          0.0,
+          [](double acc, A a, B b) { return acc + a.v * b.v; },
+          std::plus<>{}
+      );
+      sink = static_cast<std::int64_t>(sum);
+    });
+  }
+}
+
+int main(int argc, char **argv) {
+  if(argc > 1) {
+    entityCount = std::strtoull(argv[1], nullptr, 10);
+  }
+  std::cout << "entities: " << entityCount << "\n\n";
+
+  benchStore<fecs::vector_store<int>>("vector_store");
+  benchStore<fecs::unordered_map_store<int>>("unordered_map_store");
+  benchStore<fecs::huge_page_store<int>>("huge_page_store");
+  std::cout << "\n";
+
+  for(std::size_t stride : {1, 2, 10, 100}) {
+    benchMapping(stride);
+  }
+  std::cout << "\n";
+
+  benchResultTypes();
+  std::cout << "\n";
+
+  benchHandWritten();
+  std::cout << "\n";
+
+  benchReduce();
+  return 0;
+}
@@ -1,10 +1,61 @@
+#include <algorithm>
 #include <concepts>
+#include <cstdint>
 #include <optional>
+#include <type_traits>
+#include <fecs/memory_usage.hpp>
 #pragma once 
 
 namespace fecs {
   using EntityId = std::size_t;
 
+  namespace detail {
+    /**
+     * Call a forEachDifference visitor.
+     * Visitors may return false to stop the walk early; visitors returning void always continue.
+     */
+    template<typename F>
+    inline bool visitDifference(F& f, EntityId id) {
+      if constexpr(std::is_void_v<std::invoke_result_t<F&, EntityId>>) {
+        f(id);
+        return true;
+      }
+      else {
+        return static_cast<bool>(f(id));
+      }
+    }
+
+    /**
+     * Visit every id from `from` on whose std::optional slot differs between a and b,
+     * counting slots past the end of the shorter sequence as empty.
+     * Returns false if the visitor stopped the walk.
+     */
+    template<typename Slots, typename F>
+    inline bool forEachSlotDifference(const Slots& a, const Slots& b, F& f, EntityId from = 0) {
+      const auto common = std::min(a.size(), b.size());
+      for(EntityId id = from; id < common; ++id) {
+        if(a[id] != b[id] && !visitDifference(f, id)) {
+          return false;
+        }
+      }
+      const auto& longer = a.size() > common ? a : b;
+      for(EntityId id = std::max<EntityId>(from, common); id < longer.size(); ++id) {
+        if(longer[id].has_value() && !visitDifference(f, id)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * == for stores whose forEachDifference can stop early: they're equal if there is no first difference.
+     */
+    template<typename Store>
+    inline bool noDifferences(const Store& a, const Store& b) {
+      return a.forEachDifference(b, [](EntityId) { return false; });
+    }
+  }
+
   namespace concepts {
     template<typename Container, typename Component>
     concept QueryContainer = requires(const Container& c, EntityId id) {
@@ -48,6 +99,31 @@ namespace fecs {
         { c.template setMapResult<Result>(id, result) };
       };
 
+    template<typename Container>
+    concept DiffContainer =
+      requires(const Container& a, const Container& b, void (*f)(EntityId)) {
+        { a.forEachDifference(b, f) };
+      };
+
+    template<typename Container>
+    concept StateHashContainer = requires(const Container& c) {
+      { c.stateHash() } -> std::convertible_to<std::uint64_t>;
+    };
+
+    template<typename Container>
+    concept MemoryUsageContainer = requires(const Container& c) {
+      { c.memoryUsage() } -> std::convertible_to<memory_usage>;
+    };
+
+    /**
+     * Stores that can report which of 64 consecutive ids have a component as one bitmask,
+     * where bit b of word w stands for id 64 * w + b.
+     */
+    template<typename Container, typename Component>
+    concept PresenceMaskContainer = requires(const Container& c, std::size_t word) {
+      { c.template presenceWord<Component>(word) } -> std::convertible_to<std::uint64_t>;
+    };
+
     template<typename Container, typename Function, typename ...Args>
     concept ContainerMapFunction = 
       (GetUnsafeContainer<Container, Args> && ...) &&
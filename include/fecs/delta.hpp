@@ -0,0 +1,227 @@
+#pragma once
+#include "fecs/world.hpp"
+#include "fecs/diff.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  namespace detail {
+    /**
+     * Stores a delta can be computed over: either the store compares itself (tag_store compares presence only,
+     * so its marker types needn't have ==), or its components can be compared slot by slot.
+     */
+    template<typename Store>
+    concept DeltaComparable =
+      concepts::DiffContainer<Store> ||
+      std::equality_comparable<typename Store::ComponentType>;
+  }
+
+  template<typename ...Stores>
+  /**
+   * The component slots that differ between two versions of a world.
+   *
+   * A delta records, for every changed (entity, component) slot, the value that slot has in the *newer* world
+   * (or std::nullopt if the component was removed).
+   * Applying it to the older world turns it into the newer one, which lets you persist
+   * a single full snapshot followed by many small deltas instead of a full snapshot every tick.
+   */
+  class world_delta<world<Stores...>> {
+    using World = world<Stores...>;
+
+    template<typename Store>
+    using Changes = std::vector<
+      std::pair<EntityId, std::optional<typename Store::ComponentType>>
+    >;
+
+    EntityId maxId = 1;
+    std::tuple<Changes<Stores>...> changes;
+
+  public:
+    /**
+     * Compute the delta that turns `from` into `to`.
+     * This uses the same comparison as fecs::diff, so identical chunks of dense stores are skipped quickly.
+     */
+    static world_delta between(const World& from, const World& to)
+      requires (detail::DeltaComparable<Stores> && ...);
+
+    /**
+     * Given the world this delta was computed from, get the delta that undoes it.
+     * This only looks at the slots that changed.
+     */
+    inline world_delta inverse(const World& from) const;
+
+    /**
+     * Apply this delta to a world, turning it into the newer version.
+     * This only touches the slots that changed.
+     */
+    inline void applyTo(World& w) const;
+
+    /**
+     * How many (entity, component) slots changed.
+     */
+    inline std::size_t size() const {
+      return (std::get<Changes<Stores>>(changes).size() + ... + 0);
+    }
+
+    inline bool empty() const { return size() == 0; }
+
+    /**
+     * Write this delta in a compact binary format.
+     * The format is native-endian and is meant for persistence on the same platform, not interchange.
+     */
+    void write(std::ostream& out) const
+      requires (std::is_trivially_copyable_v<typename Stores::ComponentType> && ...);
+
+    /**
+     * Read a delta previously written with write().
+     * Components are rebuilt from their bytes, so they needn't be default-constructible.
+     * Throws std::runtime_error if the stream ends early.
+     */
+    static world_delta read(std::istream& in)
+      requires (std::is_trivially_copyable_v<typename Stores::ComponentType> && ...);
+
+    bool operator==(const world_delta&) const = default;
+
+  private:
+    template<typename Store>
+    inline void collect(const World& from, const World& to);
+
+    template<typename Store>
+    inline void applyStore(World& w) const;
+
+    template<typename Store>
+    inline void invertStore(const World& from, world_delta& out) const;
+
+    template<typename Value>
+    static void writeValue(std::ostream& out, const Value& value) {
+      out.write(reinterpret_cast<const char *>(&value), sizeof(Value));
+    }
+
+    template<typename Value>
+    static Value readValue(std::istream& in) {
+      std::array<char, sizeof(Value)> bytes;
+      if(!in.read(bytes.data(), bytes.size())) {
+        throw std::runtime_error("fecs: truncated world delta");
+      }
+      return std::bit_cast<Value>(bytes);
+    }
+  };
+
+  template<typename ...Stores>
+  template<typename Store>
+  inline void world_delta<world<Stores...>>::collect(
+      const World& from,
+      const World& to
+  ) {
+    using Component = typename Store::ComponentType;
+    auto& out = std::get<Changes<Store>>(changes);
+    detail::forEachComponentDifference<Component>(from, to, [&](EntityId id) {
+      out.emplace_back(id, to.template getSafe<Component>(id));
+    });
+  }
+
+  template<typename ...Stores>
+  world_delta<world<Stores...>> world_delta<world<Stores...>>::between(
+      const World& from,
+      const World& to
+  ) requires (detail::DeltaComparable<Stores> && ...) {
+    world_delta delta;
+    delta.maxId = to.maxId();
+    (delta.template collect<Stores>(from, to), ...);
+    return delta;
+  }
+
+  template<typename ...Stores>
+  template<typename Store>
+  inline void world_delta<world<Stores...>>::applyStore(World& w) const {
+    using Component = typename Store::ComponentType;
+    for(const auto& [id, value] : std::get<Changes<Store>>(changes)) {
+      detail::assignSlot<Component>(w, id, value);
+    }
+  }
+
+  template<typename ...Stores>
+  template<typename Store>
+  inline void world_delta<world<Stores...>>::invertStore(
+      const World& from,
+      world_delta& out
+  ) const {
+    using Component = typename Store::ComponentType;
+    const auto& in = std::get<Changes<Store>>(changes);
+    auto& inverted = std::get<Changes<Store>>(out.changes);
+    inverted.reserve(in.size());
+    for(const auto& change : in) {
+      inverted.emplace_back(change.first, from.template getSafe<Component>(change.first));
+    }
+  }
+
+  template<typename ...Stores>
+  inline world_delta<world<Stores...>> world_delta<world<Stores...>>::inverse(
+      const World& from
+  ) const {
+    world_delta out;
+    out.maxId = from.maxId();
+    (invertStore<Stores>(from, out), ...);
+    return out;
+  }
+
+  template<typename ...Stores>
+  inline void world_delta<world<Stores...>>::applyTo(World& w) const {
+    while(w.maxId() < maxId) {
+      w.newEntity();
+    }
+    w.lastId = maxId - 1;
+    (applyStore<Stores>(w), ...);
+  }
+
+  template<typename ...Stores>
+  void world_delta<world<Stores...>>::write(std::ostream& out) const
+    requires (std::is_trivially_copyable_v<typename Stores::ComponentType> && ...) {
+    writeValue<std::uint64_t>(out, maxId);
+    auto writeStore = [&](const auto& storeChanges) {
+      writeValue<std::uint64_t>(out, storeChanges.size());
+      for(const auto& [id, value] : storeChanges) {
+        writeValue<std::uint64_t>(out, id);
+        writeValue<std::uint8_t>(out, value.has_value());
+        if(value) {
+          writeValue(out, *value);
+        }
+      }
+    };
+    (writeStore(std::get<Changes<Stores>>(changes)), ...);
+  }
+
+  template<typename ...Stores>
+  world_delta<world<Stores...>> world_delta<world<Stores...>>::read(std::istream& in)
+    requires (std::is_trivially_copyable_v<typename Stores::ComponentType> && ...) {
+    world_delta delta;
+    delta.maxId = readValue<std::uint64_t>(in);
+    auto readStore = [&](auto& storeChanges) {
+      using Component =
+        typename std::remove_reference_t<decltype(storeChanges)>::value_type::second_type::value_type;
+      const auto count = readValue<std::uint64_t>(in);
+      for(std::uint64_t c = 0; c < count; ++c) {
+        const auto id = readValue<std::uint64_t>(in);
+        if(readValue<std::uint8_t>(in)) {
+          storeChanges.emplace_back(id, readValue<Component>(in));
+        }
+        else {
+          storeChanges.emplace_back(id, std::nullopt);
+        }
+      }
+    };
+    (readStore(std::get<Changes<Stores>>(delta.changes)), ...);
+    return delta;
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "fecs/world.hpp"
+#include "fecs/concepts.hpp"
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  /**
+   * A single (entity, component) slot that differs between two worlds.
+   * `component` is the index of the component's store in the world's store list.
+   */
+  struct difference {
+    EntityId entity;
+    std::size_t component;
+
+    auto operator<=>(const difference&) const = default;
+  };
+
+  template<typename World, typename Component>
+  struct component_index;
+
+  template<typename ...Stores, typename Component>
+  /**
+   * The index of Component's store in a world's store list, as used by difference::component.
+   */
+  struct component_index<world<Stores...>, Component> {
+    static constexpr std::size_t value = [] {
+      constexpr bool matches[] = { std::same_as<typename Stores::ComponentType, Component>... };
+      return static_cast<std::size_t>(
+        std::find(std::begin(matches), std::end(matches), true) - std::begin(matches)
+      );
+    }();
+  };
+
+  template<typename World, typename Component>
+  constexpr std::size_t component_index_v = component_index<World, Component>::value;
+
+  namespace detail {
+    /**
+     * Call f with the id of every slot of Component that differs between a and b.
+     * Uses the store's own forEachDifference if it has one, and compares slot by slot otherwise.
+     */
+    template<typename Component, typename World, typename F>
+    inline void forEachComponentDifference(const World& a, const World& b, F f) {
+      using Store = std::remove_cvref_t<decltype(a.template store<Component>())>;
+      if constexpr(concepts::DiffContainer<Store>) {
+        a.template store<Component>().forEachDifference(b.template store<Component>(), f);
+      }
+      else {
+        const auto max = std::max(a.maxId(), b.maxId());
+        for(EntityId i = 0; i < max; ++i) {
+          if(a.template getSafe<Component>(i) != b.template getSafe<Component>(i)) {
+            f(i);
+          }
+        }
+      }
+    }
+  }
+
+  template<typename ...Stores>
+  /**
+   * Find every (entity, component) slot that differs between two worlds, sorted by entity.
+   *
+   * This is meant for determinism checks between replicas: stores that support it skip over identical chunks
+   * instead of comparing element by element, so the common "nothing changed" case is cheap.
+   * Differences in the entity count alone are not reported; compare maxId() for that.
+   */
+  inline std::vector<difference> diff(
+      const world<Stores...>& a,
+      const world<Stores...>& b
+  ) {
+    std::vector<difference> result;
+    std::size_t component = 0;
+    (
+      (detail::forEachComponentDifference<typename Stores::ComponentType>(
+        a,
+        b,
+        [&](EntityId id) { result.push_back({id, component}); }
+      ), ++component),
+      ...
+    );
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+}
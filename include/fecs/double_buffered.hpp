@@ -0,0 +1,132 @@
+#pragma once
+#include "fecs/world.hpp"
+#include "fecs/concepts.hpp"
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  template<typename World>
+  class double_buffered;
+
+  template<typename ...Stores>
+  /**
+   * A world with separate read and write buffers.
+   *
+   * Mapping over a double-buffered world reads every component from the *front* buffer (the last finished frame),
+   * and writes every result into the *back* buffer (the frame being built).
+   * Because mappers are pure, this means systems never see each other's writes within a frame,
+   * so the order you run them in stops mattering.
+   * Call swap() at the end of each frame to publish the back buffer.
+   *
+   * Note: if two systems write the same component of the same entity in one frame, the last one still wins.
+   */
+  class double_buffered<world<Stores...>> {
+    using World = world<Stores...>;
+
+    World front;
+    World back;
+    std::vector<EntityId> written;
+    std::vector<bool> isWritten;
+
+  public:
+    double_buffered() = default;
+
+    explicit double_buffered(const World& initial) : front(initial), back(initial) {}
+
+    /**
+     * The last finished frame, which every read comes from.
+     */
+    inline const World& current() const { return front; }
+
+    /**
+     * Create an entity in both buffers.
+     */
+    inline EntityId newEntity() {
+      front.newEntity();
+      return back.newEntity();
+    }
+
+    inline EntityId maxId() const { return front.maxId(); }
+
+    template<typename T>
+      requires concepts::QueryContainer<World, T>
+    inline bool hasComponent(EntityId id) const {
+      return front.template hasComponent<T>(id);
+    }
+
+    template<typename ...Elements>
+      requires (concepts::QueryContainer<World, Elements> && ...)
+    inline bool hasAllComponents(EntityId id) const {
+      return front.template hasAllComponents<Elements...>(id);
+    }
+
+    template<typename T>
+      requires concepts::GetSafeContainer<World, T>
+    inline auto getSafe(EntityId id) const {
+      return front.template getSafe<T>(id);
+    }
+
+    template<typename T>
+      requires concepts::GetUnsafeContainer<World, T>
+    inline decltype(auto) getUnsafe(EntityId id) const {
+      return front.template getUnsafe<T>(id);
+    }
+
+    /**
+     * Write a component into the back buffer.
+     * It becomes visible to reads after the next swap().
+     */
+    template<typename T>
+      requires concepts::AddContainer<World, T>
+    inline void addComponent(EntityId id, T comp) {
+      back.template addComponent<T>(id, std::move(comp));
+      markWritten(id);
+    }
+
+    template<typename T>
+      requires concepts::RemoveContainer<World, T>
+    inline void removeComponent(EntityId id) {
+      back.template removeComponent<T>(id);
+      markWritten(id);
+    }
+
+    template<typename Result>
+      requires concepts::MapResultContainer<Result, World>
+    inline void setMapResult(EntityId id, const Result& result) {
+      back.template setMapResult<Result>(id, result);
+      markWritten(id);
+    }
+
+    /**
+     * Finish the frame: the back buffer becomes the front buffer.
+     *
+     * The new back buffer starts out as a copy of the new front buffer,
+     * but only the entities written during the frame are actually copied.
+     */
+    inline void swap() {
+      std::swap(front, back);
+      for(const auto id : written) {
+        (syncComponent<typename Stores::ComponentType>(id), ...);
+        isWritten[id] = false;
+      }
+      written.clear();
+    }
+
+  private:
+    inline void markWritten(EntityId id) {
+      if(isWritten.size() <= id) {
+        isWritten.resize(id + 1);
+      }
+      if(!isWritten[id]) {
+        isWritten[id] = true;
+        written.push_back(id);
+      }
+    }
+
+    template<typename Component>
+    inline void syncComponent(EntityId id) {
+      detail::assignSlot<Component>(back, id, front.template getSafe<Component>(id));
+    }
+  };
+}
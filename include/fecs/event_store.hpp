@@ -0,0 +1,145 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  template<typename T>
+  /**
+   * An append-only store for events, like `Collision` or `DamageDealt`.
+   *
+   * Adding a component appends an event for that entity instead of replacing anything,
+   * so one entity can raise many events per frame, and mappers can emit events simply by returning them.
+   * Events sit next to each other in the order they were raised, with no per-id slots,
+   * and are consumed with mapEvents rather than mapEntities.
+   *
+   * Since entities don't "have" an event the way they have a component,
+   * events can't be queried, read or removed by id; call clear() at the end of each frame instead.
+   */
+  class event_store {
+    using ElementType = T;
+
+  public:
+    struct event {
+      EntityId entity;
+      ElementType value;
+
+      bool operator==(const event&) const = default;
+    };
+
+  private:
+    std::vector<event> events;
+
+  public:
+    using ComponentType = T;
+
+    template<std::same_as<T> T2 = T>
+    bool hasComponent(EntityId) const = delete;
+
+    template<std::same_as<T> T2 = T>
+    std::optional<ElementType> getSafe(EntityId) const = delete;
+
+    template<std::same_as<T> T2 = T>
+    const ElementType& getUnsafe(EntityId) const = delete;
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp) {
+      events.push_back({id, std::move(comp)});
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      events.push_back({id, std::forward<T2&&>(c)});
+    }
+
+    template<std::same_as<T> T2 = T>
+    void removeComponent(EntityId) = delete;
+
+    inline void resizeToFit(EntityId) {}
+
+    /**
+     * Every event raised since the last clear(), oldest first.
+     */
+    inline std::span<const event> all() const { return events; }
+
+    inline std::size_t size() const { return events.size(); }
+
+    inline bool empty() const { return events.empty(); }
+
+    /**
+     * Drop every event, keeping the memory for the next frame.
+     * This is O(1) for trivially destructible events.
+     */
+    inline void clear() { events.clear(); }
+
+    bool operator==(const event_store&) const = default;
+
+    inline memory_usage memoryUsage() const {
+      return {
+        .allocatedBytes = events.capacity() * sizeof(event),
+        .liveBytes = events.size() * sizeof(ElementType),
+        .slots = events.capacity(),
+        .occupiedSlots = events.size(),
+      };
+    }
+  };
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires requires(const World& w) {
+      { w.template store<T>().all() } -> std::same_as<std::span<const typename event_store<T>::event>>;
+    } &&
+    (concepts::GetUnsafeContainer<World, Args> && ...) &&
+    concepts::MapResultContainer<std::invoke_result_t<Function, const T&, const Args&...>, World>
+  /**
+   * Call f with each event of type T in the order they were raised,
+   * plus the Args of the entity that raised it, and assign the result to that entity like mapEntities does.
+   * Events whose entity lacks any of Args are skipped.
+   *
+   * Only the events that existed when the call started are visited,
+   * so results that raise more events of the same type don't get consumed in the same pass.
+   */
+  inline void mapEvents(World& w, Function f) {
+    const auto count = w.template store<T>().size();
+    for(std::size_t i = 0; i < count; ++i) {
+      // Look the event up again each time: results may append to this store and move it.
+      const auto& e = w.template store<T>().all()[i];
+      if(w.template hasAllComponents<Args...>(e.entity)) {
+        const auto id = e.entity;
+        w.template setMapResult<decltype(f(e.value, w.template getUnsafe<Args>(id)...))>
+          (id, f(e.value, w.template getUnsafe<Args>(id)...));
+      }
+    }
+  }
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires requires(const World& w) {
+      { w.template store<T>().all() } -> std::same_as<std::span<const typename event_store<T>::event>>;
+    } &&
+    (concepts::GetUnsafeContainer<World, Args> && ...) &&
+    std::is_void_v<std::invoke_result_t<Function, const T&, const Args&...>>
+  /**
+   * Same as the above overload of mapEvents, but used for functions
+   * with a void result type.
+   */
+  inline void mapEvents(const World& w, Function f) {
+    for(const auto& e : w.template store<T>().all()) {
+      if(w.template hasAllComponents<Args...>(e.entity)) {
+        f(e.value, w.template getUnsafe<Args>(e.entity)...);
+      }
+    }
+  }
+}
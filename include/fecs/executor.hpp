@@ -0,0 +1,240 @@
+#pragma once
+#include "fecs/world.hpp"
+#include "fecs/concepts.hpp"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fecs {
+  /**
+   * Runs a batch of independent tasks on several threads.
+   *
+   * Each worker starts with an equal, contiguous share of the tasks and works through it front to back.
+   * A worker that runs out steals single tasks from the back of the other shares,
+   * so one slow share doesn't leave every other core idle.
+   * Threads only live for the duration of run(); the calling thread is one of the workers.
+   */
+  class work_stealing_executor {
+    std::size_t workers;
+
+  public:
+    explicit work_stealing_executor(std::size_t workers = std::max(1u, std::thread::hardware_concurrency()))
+      : workers(std::max<std::size_t>(1, workers)) {}
+
+    inline std::size_t workerCount() const { return workers; }
+
+    /**
+     * Call f(task) exactly once for every task in [0, tasks), and return once they're all done.
+     * If any call throws, the first exception (by task) is rethrown after every other task has run.
+     */
+    template<std::invocable<std::size_t> F>
+    inline void run(std::size_t tasks, F f) const;
+  };
+
+  template<std::invocable<std::size_t> F>
+  inline void work_stealing_executor::run(std::size_t tasks, F f) const {
+    const auto count = std::min(workers, tasks);
+    if(count == 0) {
+      return;
+    }
+
+    // The tasks a worker has left, as [next, end). The owner takes from the front and thieves from the back.
+    struct alignas(64) share {
+      std::mutex mutex;
+      std::size_t next = 0;
+      std::size_t end = 0;
+    };
+    std::vector<share> shares(count);
+    for(std::size_t k = 0; k < count; ++k) {
+      shares[k].next = tasks * k / count;
+      shares[k].end = tasks * (k + 1) / count;
+    }
+
+    auto take = [&](std::size_t k, bool own, std::size_t& task) {
+      std::lock_guard lock{shares[k].mutex};
+      if(shares[k].next == shares[k].end) {
+        return false;
+      }
+      task = own ? shares[k].next++ : --shares[k].end;
+      return true;
+    };
+
+    std::vector<std::exception_ptr> errors(tasks);
+    auto work = [&](std::size_t k) {
+      std::size_t task;
+      while(true) {
+        bool found = take(k, true, task);
+        for(std::size_t v = 1; !found && v < count; ++v) {
+          found = take((k + v) % count, false, task);
+        }
+        if(!found) {
+          return;
+        }
+        try {
+          f(task);
+        }
+        catch(...) {
+          errors[task] = std::current_exception();
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(std::size_t k = 1; k < count; ++k) {
+      threads.emplace_back(work, k);
+    }
+    work(0);
+    for(auto& t : threads) {
+      t.join();
+    }
+    for(const auto& error : errors) {
+      if(error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  namespace detail {
+    /**
+     * How much work one chunk of a parallel mapping gets: about this many entities to look at.
+     * Chunks don't depend on the number of threads, so neither does the order partial results are combined in.
+     */
+    inline constexpr std::size_t chunkWork = 16384;
+
+    struct id_range {
+      EntityId begin;
+      EntityId end;
+
+      bool operator==(const id_range&) const = default;
+    };
+
+    template<typename Element, typename World>
+    concept PresenceHint = requires(const World& w, std::size_t word) {
+      { w.template store<Element>().template presenceWord<Element>(word) } -> std::convertible_to<std::uint64_t>;
+    };
+
+    /**
+     * Whether any of Args lives in a store that reports presence 64 ids at a time (vector_store, paged_store and tag_store do).
+     */
+    template<typename World, typename ...Args>
+    inline constexpr bool hasPresenceHint = (PresenceHint<Args, World> || ...);
+
+    template<typename Element, typename World>
+    inline std::uint64_t candidateBits(const World& w, std::size_t word) {
+      if constexpr(PresenceHint<Element, World>) {
+        return w.template store<Element>().template presenceWord<Element>(word);
+      }
+      else {
+        return ~std::uint64_t{0};
+      }
+    }
+
+    /**
+     * Bit b is set if entity 64 * word + b *might* have all of Args.
+     * Only the Args with a presence hint narrow it down, so the rest still have to be checked.
+     */
+    template<typename ...Args, typename World>
+    inline std::uint64_t candidateWord(const World& w, std::size_t word) {
+      return (candidateBits<Args>(w, word) & ... & ~std::uint64_t{0});
+    }
+
+    /**
+     * Cut [0, w.maxId()) into ranges with about chunkWork candidates each,
+     * so clustered entities end up spread over many chunks instead of landing in one.
+     * Without any presence hints every id is a candidate, and the ranges are simply equal in length.
+     */
+    template<typename ...Args, typename World>
+    inline std::vector<id_range> planChunks(const World& w) {
+      const EntityId size = w.maxId();
+      std::vector<id_range> chunks;
+      if constexpr(!hasPresenceHint<World, Args...>) {
+        for(EntityId begin = 0; begin < size; begin += chunkWork) {
+          chunks.push_back({begin, std::min<EntityId>(size, begin + chunkWork)});
+        }
+      }
+      else {
+        // Skipping an empty word still costs something, so every word counts as one candidate at least.
+        EntityId begin = 0;
+        std::size_t work = 0;
+        for(std::size_t word = 0; word * 64 < size; ++word) {
+          work += 1 + static_cast<std::size_t>(std::popcount(candidateWord<Args...>(w, word)));
+          if(work >= chunkWork) {
+            const auto end = std::min<EntityId>(size, (word + 1) * 64);
+            chunks.push_back({begin, end});
+            begin = end;
+            work = 0;
+          }
+        }
+        if(begin < size) {
+          chunks.push_back({begin, size});
+        }
+      }
+      return chunks;
+    }
+
+    /**
+     * Call f(id) for every id in range that might have all of Args,
+     * skipping 64 ids at a time where a presence hint says none of them can.
+     */
+    template<typename ...Args, typename World, typename F>
+    inline void forEachCandidate(const World& w, id_range range, F& f) {
+      if constexpr(!hasPresenceHint<World, Args...>) {
+        for(EntityId i = range.begin; i < range.end; ++i) {
+          f(i);
+        }
+      }
+      else {
+        for(std::size_t word = range.begin / 64; word * 64 < range.end; ++word) {
+          auto bits = candidateWord<Args...>(w, word);
+          const auto first = word * 64;
+          if(range.begin > first) {
+            bits &= ~std::uint64_t{0} << (range.begin - first);
+          }
+          if(range.end < first + 64) {
+            bits &= (std::uint64_t{1} << (range.end - first)) - 1;
+          }
+          for(; bits != 0; bits &= bits - 1) {
+            f(first + static_cast<EntityId>(std::countr_zero(bits)));
+          }
+        }
+      }
+    }
+
+    /**
+     * Call f(chunk, range) for every planned chunk on a work_stealing_executor.
+     */
+    template<typename F>
+    inline void forEachChunk(const std::vector<id_range>& chunks, F f) {
+      work_stealing_executor{}.run(chunks.size(), [&](std::size_t chunk) { f(chunk, chunks[chunk]); });
+    }
+  }
+
+  template<
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires concepts::ContainerVoidMapFunction<World, Function, Args...>
+  /**
+   * Like the void mapEntities, but spread over every core.
+   * Work is split by how many entities actually match (see fecs::work_stealing_executor),
+   * so entities clustered in one part of the id range don't all land on one thread.
+   *
+   * The function is called from several threads at once, and in no particular order.
+   */
+  inline void mapEntitiesParallel(const World& w, Function f) {
+    detail::forEachChunk(detail::planChunks<Args...>(w), [&](std::size_t, detail::id_range range) {
+      auto visit = [&](EntityId i) {
+        if(w.template hasAllComponents<Args...>(i)) {
+          f(w.template getUnsafe<Args>(i)...);
+        }
+      };
+      detail::forEachCandidate<Args...>(w, range, visit);
+    });
+  }
+}
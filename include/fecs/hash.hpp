@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+namespace fecs {
+  namespace detail {
+    /**
+     * The splitmix64 finalizer.
+     * Spreads every input bit over the whole output so that XOR-combined hashes don't cancel out.
+     */
+    constexpr std::uint64_t mixHash(std::uint64_t x) {
+      x += 0x9e3779b97f4a7c15ull;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      return x ^ (x >> 31);
+    }
+  }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <fecs/hash.hpp>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  namespace detail {
+    /**
+     * Stores where every id refers to one shared slot, like singleton_store.
+     */
+    template<typename Store>
+    concept SharedSlotStore = requires { requires Store::sharedSlot; };
+  }
+
+  template<
+    typename Store,
+    typename Hash = std::hash<typename Store::ComponentType>
+  >
+  /**
+   * Wraps another store and keeps a running hash of its contents.
+   *
+   * The hash is the XOR of a hash of every (id, value) slot, so it is updated in O(1) on each write
+   * and does not depend on the order components were added in.
+   * This makes it cheap to compare world state between lockstep peers every tick.
+   *
+   * Store-specific bulk writes (rle_store's setRange and transformRuns, singleton_store's set) are wrapped too,
+   * so every way of writing through a hashed store keeps the hash up to date.
+   * A slot every id shares, like singleton_store's, is always hashed as entity 0.
+   *
+   * Note: the hash is only as deterministic as Hash is.
+   * std::hash is fine between identical builds, but write your own if peers run different platforms.
+   */
+  class hashed_store : public Store {
+    using ElementType = typename Store::ComponentType;
+    std::uint64_t hash = 0;
+
+    static inline std::uint64_t slotHash(EntityId id, const ElementType& value) {
+      if constexpr(detail::SharedSlotStore<Store>) {
+        id = 0;
+      }
+      return detail::mixHash(
+        detail::mixHash(id) ^ static_cast<std::uint64_t>(Hash{}(value))
+      );
+    }
+
+  public:
+    hashed_store() { hashInitialValue(); }
+
+    template<typename ...Args>
+      requires (sizeof...(Args) > 0) &&
+        (!std::derived_from<std::remove_cvref_t<Args>, hashed_store> && ...) &&
+        std::constructible_from<Store, Args...>
+    explicit hashed_store(Args&&... args) : Store(std::forward<Args>(args)...) {
+      hashInitialValue();
+    }
+
+    template<std::same_as<ElementType> T2 = ElementType>
+    inline void addComponent(EntityId id, T2 comp);
+
+    template<std::same_as<ElementType> T2 = ElementType>
+    inline void moveComponent(EntityId id, T2&& c);
+
+    template<std::same_as<ElementType> T2 = ElementType>
+    inline void removeComponent(EntityId id);
+
+    /**
+     * Store::setRange, rehashing every id in the range.
+     */
+    inline void setRange(EntityId start, EntityId length, const std::optional<ElementType>& value)
+      requires requires(Store& s, EntityId id, const std::optional<ElementType>& v) { s.setRange(id, id, v); };
+
+    /**
+     * Store::transformRuns, rehashing every id of every run.
+     */
+    template<typename F>
+      requires requires(Store& s, F f) { s.transformRuns(f); }
+    inline void transformRuns(F f);
+
+    /**
+     * Store::set, rehashing the shared slot.
+     */
+    inline void set(ElementType value)
+      requires requires(Store& s, ElementType v) { s.set(v); } {
+      unhashOld(0);
+      hash ^= slotHash(0, value);
+      Store::set(std::move(value));
+    }
+
+    /**
+     * The hash of every component in this store.
+     */
+    inline std::uint64_t stateHash() const { return hash; }
+
+    bool operator==(const hashed_store&) const = default;
+
+  private:
+    // Stores that start out holding a value, like singleton_store, hash it straight away.
+    inline void hashInitialValue() {
+      if constexpr(detail::SharedSlotStore<Store>) {
+        hash = slotHash(0, Store::template getUnsafe<ElementType>(0));
+      }
+    }
+
+    inline void unhashOld(EntityId id) {
+      if(const auto old = Store::template getSafe<ElementType>(id)) {
+        hash ^= slotHash(id, *old);
+      }
+    }
+  };
+
+  template<typename Store, typename Hash>
+  template<std::same_as<typename Store::ComponentType> T2>
+  inline void hashed_store<Store, Hash>::addComponent(EntityId id, T2 comp) {
+    unhashOld(id);
+    hash ^= slotHash(id, comp);
+    Store::template addComponent<ElementType>(id, std::move(comp));
+  }
+
+  template<typename Store, typename Hash>
+  template<std::same_as<typename Store::ComponentType> T2>
+  inline void hashed_store<Store, Hash>::moveComponent(EntityId id, T2&& c) {
+    unhashOld(id);
+    hash ^= slotHash(id, c);
+    Store::template moveComponent<ElementType>(id, std::forward<T2&&>(c));
+  }
+
+  template<typename Store, typename Hash>
+  template<std::same_as<typename Store::ComponentType> T2>
+  inline void hashed_store<Store, Hash>::removeComponent(EntityId id) {
+    unhashOld(id);
+    Store::template removeComponent<ElementType>(id);
+  }
+
+  template<typename Store, typename Hash>
+  inline void hashed_store<Store, Hash>::setRange(
+      EntityId start,
+      EntityId length,
+      const std::optional<ElementType>& value
+  ) requires requires(Store& s, EntityId id, const std::optional<ElementType>& v) { s.setRange(id, id, v); } {
+    for(auto id = start; id < start + length; ++id) {
+      unhashOld(id);
+      if(value) {
+        hash ^= slotHash(id, *value);
+      }
+    }
+    Store::setRange(start, length, value);
+  }
+
+  template<typename Store, typename Hash>
+  template<typename F>
+    requires requires(Store& s, F f) { s.transformRuns(f); }
+  inline void hashed_store<Store, Hash>::transformRuns(F f) {
+    // The store calls f once per run, in order, so results[i] is what runs[i] becomes.
+    const auto runs = Store::allRuns();
+    std::vector<std::optional<ElementType>> results;
+    results.reserve(runs.size());
+    Store::transformRuns([&](const ElementType& value) -> std::optional<ElementType> {
+      results.emplace_back(f(value));
+      return results.back();
+    });
+    for(std::size_t i = 0; i < runs.size(); ++i) {
+      for(auto id = runs[i].start; id < runs[i].end(); ++id) {
+        hash ^= slotHash(id, runs[i].value);
+        if(results[i]) {
+          hash ^= slotHash(id, *results[i]);
+        }
+      }
+    }
+  }
+}
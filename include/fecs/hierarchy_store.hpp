@@ -0,0 +1,237 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace fecs {
+  /**
+   * Component that makes an entity a child of another one.
+   * Store it in a fecs::hierarchy_store.
+   */
+  struct parent {
+    EntityId id;
+
+    bool operator==(const parent&) const = default;
+  };
+
+  /**
+   * A store for fecs::parent that also knows the depth-first order of the whole forest,
+   * so mapHierarchy can walk every tree parents-first in one linear pass.
+   *
+   * The order is rebuilt lazily, in O(ids), the first time it's needed after a parent was added or removed.
+   * Roots are entities with children but no parent, and siblings are visited in id order.
+   * Entities caught in a parent cycle (and their descendants) have no root, so they are left out.
+   *
+   * Since rebuilding happens inside const functions, don't read the order from several threads
+   * right after changing parents.
+   */
+  class hierarchy_store {
+    using ElementType = parent;
+
+  public:
+    struct node {
+      EntityId id;
+      std::size_t depth;
+
+      bool operator==(const node&) const = default;
+    };
+
+  private:
+    std::vector<std::optional<ElementType>> elements;
+    std::size_t count = 0;
+    mutable std::vector<node> order;
+    mutable bool dirty = false;
+
+  public:
+    using ComponentType = parent;
+
+    template<std::same_as<parent> T2 = parent>
+    inline bool hasComponent(EntityId id) const {
+      return id < elements.size() && elements[id].has_value();
+    }
+
+    template<std::same_as<parent> T2 = parent>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(id >= elements.size()) {
+        return std::nullopt;
+      }
+      return elements[id];
+    }
+
+    template<std::same_as<parent> T2 = parent>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *elements[id];
+    }
+
+    template<std::same_as<parent> T2 = parent>
+    inline void addComponent(EntityId id, T2 comp) {
+      resizeToFit(id);
+      if(!elements[id]) {
+        ++count;
+      }
+      else if(*elements[id] == comp) {
+        return;
+      }
+      elements[id] = comp;
+      dirty = true;
+    }
+
+    template<std::same_as<parent> T2 = parent>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, c);
+    }
+
+    template<std::same_as<parent> T2 = parent>
+    inline void removeComponent(EntityId id) {
+      if(!hasComponent(id)) {
+        return;
+      }
+      elements[id] = std::nullopt;
+      --count;
+      dirty = true;
+    }
+
+    inline void resizeToFit(EntityId id) {
+      elements.resize(std::max(elements.size(), id + 1));
+    }
+
+    /**
+     * Every entity in a tree, parents before their children, with roots at depth 0.
+     */
+    inline const std::vector<node>& depthFirst() const {
+      if(dirty) {
+        rebuild();
+      }
+      return order;
+    }
+
+    /**
+     * Call f with the id of every slot that differs from other, until f returns false.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const hierarchy_store& other, F f) const {
+      return detail::forEachSlotDifference(elements, other.elements, f);
+    }
+
+    /**
+     * Stores are equal if they hold the same parents; the order is derived from them.
+     */
+    inline bool operator==(const hierarchy_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    inline memory_usage memoryUsage() const {
+      return {
+        .allocatedBytes =
+          elements.capacity() * sizeof(std::optional<ElementType>) +
+          order.capacity() * sizeof(node),
+        .liveBytes = count * sizeof(ElementType),
+        .slots = elements.size(),
+        .occupiedSlots = count,
+      };
+    }
+
+  private:
+    inline void rebuild() const;
+  };
+
+  inline void hierarchy_store::rebuild() const {
+    // Parents may point past our slots, at entities that only show up as roots.
+    std::size_t size = elements.size();
+    for(const auto& p : elements) {
+      if(p) {
+        size = std::max(size, p->id + 1);
+      }
+    }
+
+    // Children of each entity, grouped by parent in id order.
+    std::vector<std::size_t> firstChild(size + 1, 0);
+    for(const auto& p : elements) {
+      if(p) {
+        ++firstChild[p->id + 1];
+      }
+    }
+    for(std::size_t i = 0; i < size; ++i) {
+      firstChild[i + 1] += firstChild[i];
+    }
+    std::vector<EntityId> children(count);
+    auto next = firstChild;
+    for(EntityId id = 0; id < elements.size(); ++id) {
+      if(elements[id]) {
+        children[next[elements[id]->id]++] = id;
+      }
+    }
+
+    order.clear();
+    std::vector<node> pending;
+    for(EntityId root = 0; root < size; ++root) {
+      if(hasComponent(root) || firstChild[root] == firstChild[root + 1]) {
+        continue;
+      }
+      pending.push_back({root, 0});
+      while(!pending.empty()) {
+        const auto current = pending.back();
+        pending.pop_back();
+        order.push_back(current);
+        // Push in reverse so siblings come off the stack in id order.
+        for(auto c = firstChild[current.id + 1]; c > firstChild[current.id]; --c) {
+          pending.push_back({children[c - 1], current.depth + 1});
+        }
+      }
+    }
+    dirty = false;
+  }
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires requires(const World& w) {
+      { w.template store<parent>().depthFirst() } -> std::same_as<const std::vector<hierarchy_store::node>&>;
+    } &&
+    (concepts::GetUnsafeContainer<World, Args> && ...) &&
+    concepts::AddContainer<World, T> &&
+    std::convertible_to<std::invoke_result_t<Function, const std::optional<T>&, const Args&...>, T>
+  /**
+   * Propagate a value down every hierarchy, like turning local transforms into world transforms:
+   *
+   * ```cpp
+   * fecs::mapHierarchy<WorldTransform, LocalTransform>(w,
+   *   [](const std::optional<WorldTransform>& parent, const LocalTransform& local) {
+   *     return parent ? parent->then(local) : WorldTransform{local};
+   *   });
+   * ```
+   *
+   * Entities are visited parents-first in one linear pass over the cached depth-first order.
+   * The mapper gets the T just computed for the parent (or std::nullopt for roots) and the entity's own Args,
+   * and its result is written as the entity's T.
+   * The parent's result comes from a small per-depth stack rather than a lookup through the world.
+   *
+   * An entity missing any of Args is skipped, and its children get std::nullopt as their parent's value.
+   * Entities outside any hierarchy are not visited.
+   */
+  inline void mapHierarchy(World& w, Function f) {
+    const std::optional<T> none;
+    std::vector<std::optional<T>> byDepth;
+    for(const auto& n : w.template store<parent>().depthFirst()) {
+      if(byDepth.size() <= n.depth) {
+        byDepth.resize(n.depth + 1);
+      }
+      auto& result = byDepth[n.depth];
+      if(w.template hasAllComponents<Args...>(n.id)) {
+        const auto& fromParent = n.depth > 0 ? byDepth[n.depth - 1] : none;
+        result = f(fromParent, w.template getUnsafe<Args>(n.id)...);
+        w.template addComponent<T>(n.id, *result);
+      }
+      else {
+        result = std::nullopt;
+      }
+    }
+  }
+}
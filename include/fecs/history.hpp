@@ -0,0 +1,102 @@
+#pragma once
+#include "fecs/delta.hpp"
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+
+namespace fecs {
+  template<typename World>
+  /**
+   * Keeps the last few frames of a world around so you can roll back to them.
+   *
+   * Only the newest frame is stored in full.
+   * Every older frame is stored as the delta that undoes the frame after it,
+   * so memory grows with how much changed per frame, not with the size of the world.
+   *
+   * A typical rollback looks like:
+   *
+   * ```cpp
+   * World w = history.rewind(3);
+   * for(auto& input : correctedInputs) {
+   *   simulate(w, input);
+   *   history.push(w);
+   * }
+   * ```
+   */
+  class history {
+    std::optional<World> latest;
+    std::deque<world_delta<World>> undo;
+    std::size_t capacity;
+
+  public:
+    /**
+     * Make a history that retains at most `frames` frames, including the newest one.
+     */
+    explicit history(std::size_t frames) : capacity(frames) {
+      if(frames == 0) {
+        throw std::invalid_argument("fecs::history must retain at least one frame");
+      }
+    }
+
+    /**
+     * Record a new frame, dropping the oldest one if the history is full.
+     * This costs one comparison against the previous frame, plus work proportional to what changed.
+     */
+    inline void push(const World& w);
+
+    /**
+     * Drop the newest `frames` frames and get the world as it was before them.
+     * Throws std::out_of_range if fewer than `frames + 1` frames are retained.
+     */
+    inline const World& rewind(std::size_t frames);
+
+    /**
+     * The newest frame.
+     * Throws std::out_of_range if nothing was pushed yet.
+     */
+    inline const World& current() const {
+      if(!latest) {
+        throw std::out_of_range("fecs::history is empty");
+      }
+      return *latest;
+    }
+
+    /**
+     * How many frames are retained, including the newest one.
+     */
+    inline std::size_t size() const {
+      return latest ? undo.size() + 1 : 0;
+    }
+
+    inline bool empty() const { return !latest; }
+  };
+
+  template<typename World>
+  inline void history<World>::push(const World& w) {
+    if(!latest) {
+      latest = w;
+      return;
+    }
+    const auto forward = world_delta<World>::between(*latest, w);
+    if(capacity > 1) {
+      undo.push_back(forward.inverse(*latest));
+      if(undo.size() >= capacity) {
+        undo.pop_front();
+      }
+    }
+    forward.applyTo(*latest);
+  }
+
+  template<typename World>
+  inline const World& history<World>::rewind(std::size_t frames) {
+    if(frames >= size()) {
+      throw std::out_of_range("fecs::history cannot rewind past its oldest frame");
+    }
+    for(std::size_t i = 0; i < frames; ++i) {
+      undo.back().applyTo(*latest);
+      undo.pop_back();
+    }
+    return *latest;
+  }
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <fecs/vector_store.hpp>
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fecs {
+  namespace detail {
+    inline constexpr std::size_t hugePageSize = std::size_t{2} << 20;
+
+    /**
+     * How many bytes to map for a buffer of `bytes`:
+     * whole huge pages once it's big enough to benefit from them, whole normal pages otherwise.
+     */
+    inline std::size_t hugePageMappingSize(std::size_t bytes) {
+#ifdef __linux__
+      const std::size_t granule = bytes >= hugePageSize
+        ? hugePageSize
+        : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      return (bytes + granule - 1) / granule * granule;
+#else
+      return bytes;
+#endif
+    }
+  }
+
+  template<typename T>
+  /**
+   * A standard allocator that hands out memory backed by transparent huge pages where possible
+   * (see huge_page_vector), and plain malloc memory off Linux.
+   *
+   * It works with any allocator-aware container.
+   * vector_store additionally keeps its slots in a huge_page_vector when given this allocator,
+   * so growing the store remaps pages instead of allocating, copying and freeing.
+   */
+  struct huge_page_allocator {
+    using value_type = T;
+
+    huge_page_allocator() = default;
+
+    template<typename U>
+    huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+    inline T *allocate(std::size_t n);
+    inline void deallocate(T *p, std::size_t n) noexcept;
+
+    template<typename U>
+    inline bool operator==(const huge_page_allocator<U>&) const noexcept { return true; }
+  };
+
+#ifdef __linux__
+  template<typename T>
+  inline T *huge_page_allocator<T>::allocate(std::size_t n) {
+    const auto bytes = detail::hugePageMappingSize(n * sizeof(T));
+    void *mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mapped == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    if(bytes >= detail::hugePageSize) {
+      madvise(mapped, bytes, MADV_HUGEPAGE);
+    }
+    return static_cast<T *>(mapped);
+  }
+
+  template<typename T>
+  inline void huge_page_allocator<T>::deallocate(T *p, std::size_t n) noexcept {
+    munmap(p, detail::hugePageMappingSize(n * sizeof(T)));
+  }
+#else
+  template<typename T>
+  inline T *huge_page_allocator<T>::allocate(std::size_t n) {
+    void *allocated = std::malloc(n * sizeof(T));
+    if(allocated == nullptr) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(allocated);
+  }
+
+  template<typename T>
+  inline void huge_page_allocator<T>::deallocate(T *p, std::size_t) noexcept {
+    std::free(p);
+  }
+#endif
+
+  template<typename T>
+    requires std::is_trivially_copyable_v<T>
+  /**
+   * A minimal vector for huge arrays of trivially copyable values.
+   *
+   * On Linux the buffer is an anonymous mapping with MADV_HUGEPAGE set once it is large enough,
+   * so scanning it takes far fewer TLB misses.
+   * Growing uses mremap, which moves page table entries instead of copying the contents.
+   * Elsewhere it falls back to malloc and realloc.
+   *
+   * Note: this uses transparent huge pages rather than MAP_HUGETLB,
+   * since hugetlbfs mappings need a pre-reserved pool and can't be grown with mremap on many kernels.
+   */
+  class huge_page_vector {
+    T *ptr = nullptr;
+    std::size_t count = 0;
+    std::size_t cap = 0;
+    std::size_t mappedBytes = 0;
+
+  public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    huge_page_vector() = default;
+
+    huge_page_vector(const huge_page_vector& other) {
+      reserve(other.count);
+      copyFrom(other);
+    }
+
+    huge_page_vector(huge_page_vector&& other) noexcept { swap(other); }
+
+    huge_page_vector& operator=(const huge_page_vector& other) {
+      if(this != &other) {
+        reserve(other.count);
+        copyFrom(other);
+      }
+      return *this;
+    }
+
+    huge_page_vector& operator=(huge_page_vector&& other) noexcept {
+      swap(other);
+      return *this;
+    }
+
+    ~huge_page_vector() { release(); }
+
+    inline std::size_t size() const { return count; }
+    inline std::size_t capacity() const { return cap; }
+    inline bool empty() const { return count == 0; }
+
+    inline T *data() { return ptr; }
+    inline const T *data() const { return ptr; }
+
+    inline T *begin() { return ptr; }
+    inline T *end() { return ptr + count; }
+    inline const T *begin() const { return ptr; }
+    inline const T *end() const { return ptr + count; }
+
+    inline T& operator[](std::size_t i) { return ptr[i]; }
+    inline const T& operator[](std::size_t i) const { return ptr[i]; }
+
+    inline T& at(std::size_t i) {
+      if(i >= count) {
+        throw std::out_of_range("fecs::huge_page_vector::at");
+      }
+      return ptr[i];
+    }
+
+    inline const T& at(std::size_t i) const {
+      return const_cast<huge_page_vector&>(*this).at(i);
+    }
+
+    /**
+     * Grow or shrink to n elements. New elements are value-initialized.
+     */
+    inline void resize(std::size_t n) {
+      if(n > cap) {
+        reserve(std::max(n, cap * 2));
+      }
+      for(std::size_t i = count; i < n; ++i) {
+        new (ptr + i) T();
+      }
+      count = n;
+    }
+
+    inline void reserve(std::size_t n);
+
+    inline void swap(huge_page_vector& other) noexcept {
+      std::swap(ptr, other.ptr);
+      std::swap(count, other.count);
+      std::swap(cap, other.cap);
+      std::swap(mappedBytes, other.mappedBytes);
+    }
+
+    inline bool operator==(const huge_page_vector& other) const {
+      return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    inline auto operator<=>(const huge_page_vector& other) const
+      requires std::three_way_comparable<T> {
+      return std::lexicographical_compare_three_way(begin(), end(), other.begin(), other.end());
+    }
+
+  private:
+    inline void copyFrom(const huge_page_vector& other) {
+      if(other.count > 0) {
+        std::memcpy(ptr, other.ptr, other.count * sizeof(T));
+      }
+      count = other.count;
+    }
+
+    inline void release();
+  };
+
+#ifdef __linux__
+  template<typename T>
+    requires std::is_trivially_copyable_v<T>
+  inline void huge_page_vector<T>::reserve(std::size_t n) {
+    if(n <= cap) {
+      return;
+    }
+    const auto bytes = detail::hugePageMappingSize(n * sizeof(T));
+    void *mapped = ptr == nullptr
+      ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+      : mremap(ptr, mappedBytes, bytes, MREMAP_MAYMOVE);
+    if(mapped == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    if(bytes >= detail::hugePageSize) {
+      // Only a hint: without transparent huge pages this just fails and we keep normal pages.
+      madvise(mapped, bytes, MADV_HUGEPAGE);
+    }
+    ptr = static_cast<T *>(mapped);
+    mappedBytes = bytes;
+    cap = bytes / sizeof(T);
+  }
+
+  template<typename T>
+    requires std::is_trivially_copyable_v<T>
+  inline void huge_page_vector<T>::release() {
+    if(ptr != nullptr) {
+      munmap(ptr, mappedBytes);
+    }
+    ptr = nullptr;
+    count = cap = mappedBytes = 0;
+  }
+#else
+  template<typename T>
+    requires std::is_trivially_copyable_v<T>
+  inline void huge_page_vector<T>::reserve(std::size_t n) {
+    if(n <= cap) {
+      return;
+    }
+    void *grown = std::realloc(ptr, n * sizeof(T));
+    if(grown == nullptr) {
+      throw std::bad_alloc();
+    }
+    ptr = static_cast<T *>(grown);
+    mappedBytes = n * sizeof(T);
+    cap = n;
+  }
+
+  template<typename T>
+    requires std::is_trivially_copyable_v<T>
+  inline void huge_page_vector<T>::release() {
+    std::free(ptr);
+    ptr = nullptr;
+    count = cap = mappedBytes = 0;
+  }
+#endif
+
+  namespace detail {
+    template<typename T, typename U>
+    struct vector_store_storage<T, huge_page_allocator<U>> {
+      using type = huge_page_vector<std::optional<T>>;
+    };
+  }
+
+  /**
+   * A vector_store for large, dense, trivially copyable components.
+   * Its slots live on huge pages and growing it never copies them.
+   */
+  template<typename T>
+  using huge_page_store = vector_store<T, huge_page_allocator<T>>;
+}
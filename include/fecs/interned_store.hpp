@@ -0,0 +1,235 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <fecs/hash.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace fecs {
+  template<typename T, typename Hash = std::hash<T>>
+  /**
+   * A store that keeps one copy of each distinct value and a small index per entity.
+   *
+   * This is meant for heavy components many entities share, such as material descriptors or AI configs:
+   * a thousand entities with the same material cost a thousand 4-byte indices plus a single material.
+   * Writes hash-cons the new value, so setting an entity to a value some other entity already has is a lookup,
+   * and values nobody uses any more are destroyed and their pool slots reused.
+   *
+   * The pool holds the only copy of each value: the hash-cons table is an open-addressed table of pool indices.
+   *
+   * getUnsafe returns a reference into the pool, which stays valid until the next write to this store.
+   */
+  class interned_store {
+    using ElementType = T;
+    using Index = std::uint32_t;
+    static constexpr Index none = std::numeric_limits<Index>::max();
+
+    std::vector<Index> indices;
+    // Released slots are empty until a new value reuses them.
+    std::vector<std::optional<ElementType>> pool;
+    std::vector<std::size_t> hashes;
+    std::vector<Index> refs;
+    std::vector<Index> freeSlots;
+    // Pool indices by the hash of their value, probed linearly; `none` marks an empty bucket.
+    std::vector<Index> table;
+    std::size_t distinct = 0;
+
+  public:
+    using ComponentType = T;
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return id < indices.size() && indices[id] != none;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(!hasComponent(id)) {
+        return std::nullopt;
+      }
+      return *pool[indices[id]];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *pool[indices[id]];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp);
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, std::forward<T2&&>(c));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id) {
+      if(!hasComponent(id)) {
+        return;
+      }
+      release(indices[id]);
+      indices[id] = none;
+    }
+
+    inline void resizeToFit(EntityId id) {
+      indices.resize(std::max(indices.size(), id + 1), none);
+    }
+
+    /**
+     * How many distinct values are currently in use.
+     */
+    inline std::size_t uniqueCount() const { return distinct; }
+
+    /**
+     * Call f with the id of every component that differs from other, until f returns false.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const interned_store& other, F f) const {
+      const auto count = std::max(indices.size(), other.indices.size());
+      for(EntityId id = 0; id < count; ++id) {
+        const bool mine = hasComponent(id);
+        if(mine != other.hasComponent(id) || (mine && !(getUnsafe(id) == other.getUnsafe(id)))) {
+          if(!detail::visitDifference(f, id)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    inline bool operator==(const interned_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    /**
+     * Live bytes only count each distinct value once; the per-entity indices and the
+     * hash-cons table are overhead.
+     */
+    inline memory_usage memoryUsage() const;
+
+  private:
+    inline Index intern(ElementType value);
+
+    inline void release(Index index);
+
+    inline std::size_t home(std::size_t hash) const {
+      return static_cast<std::size_t>(detail::mixHash(hash)) & (table.size() - 1);
+    }
+
+    // The bucket holding an equal value, or the empty bucket where it would go.
+    inline std::size_t bucketFor(const ElementType& value, std::size_t hash) const {
+      const auto mask = table.size() - 1;
+      for(auto b = home(hash); ; b = (b + 1) & mask) {
+        if(table[b] == none || (hashes[table[b]] == hash && *pool[table[b]] == value)) {
+          return b;
+        }
+      }
+    }
+
+    // Double the table (keeping it at most 3/4 full) and reinsert every index.
+    inline void grow();
+  };
+
+  template<typename T, typename Hash>
+  inline auto interned_store<T, Hash>::intern(ElementType value) -> Index {
+    if(4 * (distinct + 1) > 3 * table.size()) {
+      grow();
+    }
+    const auto hash = static_cast<std::size_t>(Hash{}(value));
+    const auto bucket = bucketFor(value, hash);
+    if(table[bucket] != none) {
+      return table[bucket];
+    }
+    Index index;
+    if(!freeSlots.empty()) {
+      index = freeSlots.back();
+      freeSlots.pop_back();
+      pool[index].emplace(std::move(value));
+      hashes[index] = hash;
+    }
+    else {
+      index = static_cast<Index>(pool.size());
+      pool.emplace_back(std::move(value));
+      hashes.push_back(hash);
+      refs.push_back(0);
+    }
+    table[bucket] = index;
+    ++distinct;
+    return index;
+  }
+
+  template<typename T, typename Hash>
+  inline void interned_store<T, Hash>::release(Index index) {
+    if(--refs[index] != 0) {
+      return;
+    }
+    // Backward-shift deletion: pull later entries of the probe run into the hole
+    // unless that would move them before their home bucket.
+    const auto mask = table.size() - 1;
+    auto hole = bucketFor(*pool[index], hashes[index]);
+    for(auto next = (hole + 1) & mask; table[next] != none; next = (next + 1) & mask) {
+      const auto h = home(hashes[table[next]]);
+      if(((next - h) & mask) >= ((next - hole) & mask)) {
+        table[hole] = table[next];
+        hole = next;
+      }
+    }
+    table[hole] = none;
+    --distinct;
+    pool[index].reset();
+    freeSlots.push_back(index);
+  }
+
+  template<typename T, typename Hash>
+  inline void interned_store<T, Hash>::grow() {
+    auto old = std::move(table);
+    table.assign(std::max<std::size_t>(16, old.size() * 2), none);
+    const auto mask = table.size() - 1;
+    for(const auto index : old) {
+      if(index == none) {
+        continue;
+      }
+      auto b = home(hashes[index]);
+      while(table[b] != none) {
+        b = (b + 1) & mask;
+      }
+      table[b] = index;
+    }
+  }
+
+  template<typename T, typename Hash>
+  template<std::same_as<T> T2>
+  inline void interned_store<T, Hash>::addComponent(EntityId id, T2 comp) {
+    resizeToFit(id);
+    const auto index = intern(std::move(comp));
+    ++refs[index];
+    if(indices[id] != none) {
+      release(indices[id]);
+    }
+    indices[id] = index;
+  }
+
+  template<typename T, typename Hash>
+  inline memory_usage interned_store<T, Hash>::memoryUsage() const {
+    const auto occupied = static_cast<std::size_t>(
+      std::count_if(indices.begin(), indices.end(), [](Index i) { return i != none; })
+    );
+    return {
+      .allocatedBytes =
+        indices.capacity() * sizeof(Index) +
+        pool.capacity() * sizeof(std::optional<ElementType>) +
+        hashes.capacity() * sizeof(std::size_t) +
+        (refs.capacity() + freeSlots.capacity() + table.capacity()) * sizeof(Index),
+      .liveBytes = distinct * sizeof(ElementType),
+      .slots = indices.size(),
+      .occupiedSlots = occupied,
+    };
+  }
+}
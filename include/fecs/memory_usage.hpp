@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+namespace fecs {
+  /**
+   * How much memory a store uses.
+   *
+   * Only the store's own allocations are counted:
+   * heap memory owned *by* components (the characters of a std::string, say) is not included.
+   */
+  struct memory_usage {
+    /**
+     * Bytes the store has allocated, including unused capacity and bookkeeping.
+     */
+    std::size_t allocatedBytes = 0;
+
+    /**
+     * Bytes actually holding components (occupied slots times the component size).
+     */
+    std::size_t liveBytes = 0;
+
+    /**
+     * How many slots the store has room for, and how many of those hold a component.
+     */
+    std::size_t slots = 0;
+    std::size_t occupiedSlots = 0;
+
+    /**
+     * Bytes spent on anything other than components: empty slots, std::optional flags and padding, map nodes...
+     */
+    inline std::size_t overheadBytes() const {
+      return allocatedBytes - liveBytes;
+    }
+
+    inline double occupancy() const {
+      return slots == 0 ? 0.0 : static_cast<double>(occupiedSlots) / static_cast<double>(slots);
+    }
+
+    inline memory_usage& operator+=(const memory_usage& other) {
+      allocatedBytes += other.allocatedBytes;
+      liveBytes += other.liveBytes;
+      slots += other.slots;
+      occupiedSlots += other.occupiedSlots;
+      return *this;
+    }
+
+    bool operator==(const memory_usage&) const = default;
+  };
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  template<typename T, typename Compare = std::less<T>>
+  /**
+   * A store that also keeps its components sorted by value,
+   * for queries like "everyone with less than 10 health" or "the top 100 scores".
+   *
+   * The sorted index holds ids and is updated on every add and remove, so it's always in sync with the components,
+   * at the cost of an O(log n) update per write.
+   * See mapEntitiesWhere for mapping over a range of values.
+   */
+  class ordered_store {
+    using ElementType = T;
+    using Slots = std::vector<std::optional<ElementType>>;
+
+    // A search key for the index: sorts before every id whose component is equivalent to `value`.
+    struct bound {
+      const ElementType& value;
+    };
+
+    // Orders ids by their component, then by id.
+    // Components are read from the slots, so the index never holds a copy that could go stale.
+    struct by_value {
+      using is_transparent = void;
+
+      const Slots *slots;
+      [[no_unique_address]] Compare compare;
+
+      inline const ElementType& value(EntityId id) const { return *(*slots)[id]; }
+
+      inline bool operator()(EntityId a, EntityId b) const {
+        if(compare(value(a), value(b))) {
+          return true;
+        }
+        if(compare(value(b), value(a))) {
+          return false;
+        }
+        return a < b;
+      }
+
+      inline bool operator()(EntityId a, const bound& b) const { return compare(value(a), b.value); }
+      inline bool operator()(const bound& b, EntityId a) const { return !compare(value(a), b.value); }
+    };
+
+    Slots elements;
+    std::set<EntityId, by_value> index{by_value{&elements, Compare{}}};
+
+  public:
+    using ComponentType = T;
+
+    ordered_store() = default;
+
+    // The index's comparator points at this store's slots, so copies and moves rebuild it around their own.
+    ordered_store(const ordered_store& other)
+      : elements(other.elements),
+        index(other.index.begin(), other.index.end(), by_value{&elements, Compare{}}) {}
+
+    ordered_store(ordered_store&& other) : elements(std::move(other.elements)) {
+      takeIndex(other);
+    }
+
+    ordered_store& operator=(const ordered_store& other) {
+      if(this != &other) {
+        elements = other.elements;
+        index = std::set<EntityId, by_value>(other.index.begin(), other.index.end(), by_value{&elements, Compare{}});
+      }
+      return *this;
+    }
+
+    ordered_store& operator=(ordered_store&& other) {
+      if(this != &other) {
+        index.clear();
+        elements = std::move(other.elements);
+        takeIndex(other);
+      }
+      return *this;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return id < elements.size() && elements[id].has_value();
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(id >= elements.size()) {
+        return std::nullopt;
+      }
+      return elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp) {
+      resizeToFit(id);
+      if(elements[id]) {
+        // An equivalent value sorts the same, so the id can stay where it is in the index.
+        if(!differs(*elements[id], comp)) {
+          elements[id] = std::move(comp);
+          return;
+        }
+        index.erase(id);
+      }
+      elements[id] = std::move(comp);
+      index.insert(id);
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, std::forward<T2&&>(c));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id) {
+      if(!hasComponent(id)) {
+        return;
+      }
+      index.erase(id);
+      elements[id] = std::nullopt;
+    }
+
+    inline void resizeToFit(EntityId id) {
+      elements.resize(std::max(elements.size(), id + 1));
+    }
+
+    /**
+     * Call f(id, component) for every component in [lo, hi), in ascending order.
+     * Ties are visited in id order.
+     */
+    template<std::invocable<EntityId, const ElementType&> F>
+    inline void forEachInRange(const ElementType& lo, const ElementType& hi, F f) const {
+      const auto end = index.lower_bound(bound{hi});
+      for(auto it = index.lower_bound(bound{lo}); it != end; ++it) {
+        f(*it, *elements[*it]);
+      }
+    }
+
+    /**
+     * The ids of every component in [lo, hi), in ascending order.
+     */
+    inline std::vector<EntityId> idsInRange(const ElementType& lo, const ElementType& hi) const {
+      std::vector<EntityId> ids;
+      forEachInRange(lo, hi, [&](EntityId id, const ElementType&) { ids.push_back(id); });
+      return ids;
+    }
+
+    /**
+     * The ids of the n smallest components, smallest first.
+     */
+    inline std::vector<EntityId> lowest(std::size_t n) const {
+      std::vector<EntityId> ids;
+      for(auto it = index.begin(); it != index.end() && ids.size() < n; ++it) {
+        ids.push_back(*it);
+      }
+      return ids;
+    }
+
+    /**
+     * The ids of the n largest components, largest first.
+     */
+    inline std::vector<EntityId> highest(std::size_t n) const {
+      std::vector<EntityId> ids;
+      for(auto it = index.rbegin(); it != index.rend() && ids.size() < n; ++it) {
+        ids.push_back(*it);
+      }
+      return ids;
+    }
+
+    inline std::size_t size() const { return index.size(); }
+
+    /**
+     * Call f with the id of every slot that differs from other, until f returns false.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const ordered_store& other, F f) const {
+      return detail::forEachSlotDifference(elements, other.elements, f);
+    }
+
+    /**
+     * Stores are equal if they hold the same components; the index is derived from them.
+     */
+    inline bool operator==(const ordered_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    inline memory_usage memoryUsage() const {
+      // A std::set node is the id plus three pointers and a colour.
+      constexpr auto nodeBytes = sizeof(EntityId) + 4 * sizeof(void *);
+      return {
+        .allocatedBytes = elements.capacity() * sizeof(std::optional<ElementType>) + index.size() * nodeBytes,
+        .liveBytes = index.size() * sizeof(ElementType),
+        .slots = elements.size(),
+        .occupiedSlots = index.size(),
+      };
+    }
+
+  private:
+    // Move other's index nodes into ours; our slots must already hold other's components.
+    inline void takeIndex(ordered_store& other) {
+      while(!other.index.empty()) {
+        index.insert(index.end(), other.index.extract(other.index.begin()));
+      }
+    }
+
+    inline bool differs(const ElementType& a, const ElementType& b) const {
+      const Compare compare;
+      return compare(a, b) || compare(b, a);
+    }
+  };
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires requires(const World& w, const T& value) {
+      { w.template store<T>().idsInRange(value, value) } -> std::same_as<std::vector<EntityId>>;
+    } &&
+    concepts::ContainerMapFunction<World, Function, T, Args...>
+  /**
+   * Like mapEntities<T, Args...>, but only visits entities whose T (which must live in an ordered_store)
+   * is in [lo, hi), in ascending order of T.
+   * Finding them costs O(log n + matches) instead of a scan over every id.
+   *
+   * The matching ids are collected before any mapper runs, so results that move an entity in or out of the range
+   * don't change which entities are visited.
+   */
+  inline void mapEntitiesWhere(World& w, const T& lo, const T& hi, Function f) {
+    for(const auto id : w.template store<T>().idsInRange(lo, hi)) {
+      if(w.template hasAllComponents<T, Args...>(id)) {
+        w.template setMapResult<decltype(f(w.template getUnsafe<T>(id), w.template getUnsafe<Args>(id)...))>
+          (id, f(w.template getUnsafe<T>(id), w.template getUnsafe<Args>(id)...));
+      }
+    }
+  }
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires requires(const World& w, const T& value) {
+      { w.template store<T>().idsInRange(value, value) } -> std::same_as<std::vector<EntityId>>;
+    } &&
+    concepts::ContainerVoidMapFunction<World, Function, T, Args...>
+  /**
+   * Same as the above overload of mapEntitiesWhere, but used for functions
+   * with a void result type.
+   */
+  inline void mapEntitiesWhere(const World& w, const T& lo, const T& hi, Function f) {
+    w.template store<T>().forEachInRange(lo, hi, [&](EntityId id, const T& value) {
+      if(w.template hasAllComponents<Args...>(id)) {
+        f(value, w.template getUnsafe<Args>(id)...);
+      }
+    });
+  }
+}
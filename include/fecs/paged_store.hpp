@@ -0,0 +1,222 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace fecs {
+  template<typename T, std::size_t PageSize = 1024>
+  /**
+   * A store that splits the id range into fixed-size pages, allocated only when something is written to them.
+   *
+   * Unlike vector_store, growing never moves existing components:
+   * only the small table of page pointers is ever reallocated.
+   * This means no latency spikes when ids grow, references from getUnsafe stay valid until that component is
+   * replaced or removed, and memory is proportional to the id ranges actually in use.
+   * A page is freed again once its last component is removed.
+   *
+   * Each page also keeps a presence bit per slot, updated on every add and remove (see presenceWord).
+   */
+  class paged_store {
+    static_assert(PageSize > 0, "pages must hold at least one component");
+
+    using ElementType = T;
+
+    struct page {
+      std::array<std::optional<ElementType>, PageSize> slots{};
+      std::array<std::uint64_t, (PageSize + 63) / 64> presence{};
+      std::size_t occupied = 0;
+    };
+
+    std::vector<std::unique_ptr<page>> pages;
+
+  public:
+    using ComponentType = T;
+
+    paged_store() = default;
+    paged_store(paged_store&&) = default;
+    paged_store& operator=(paged_store&&) = default;
+
+    paged_store(const paged_store& other) { *this = other; }
+
+    paged_store& operator=(const paged_store& other) {
+      if(this == &other) {
+        return *this;
+      }
+      pages.clear();
+      pages.resize(other.pages.size());
+      for(std::size_t p = 0; p < pages.size(); ++p) {
+        if(other.pages[p]) {
+          pages[p] = std::make_unique<page>(*other.pages[p]);
+        }
+      }
+      return *this;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return slot(id) != nullptr;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(const auto s = slot(id)) {
+        return *s;
+      }
+      return std::nullopt;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *pages[id / PageSize]->slots[id % PageSize];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp) {
+      emplace(id, std::move(comp));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      emplace(id, std::forward<T2&&>(c));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id);
+
+    /**
+     * Only grows the page table; pages themselves are allocated on first write.
+     */
+    inline void resizeToFit(EntityId id) {
+      pages.resize(std::max(pages.size(), id / PageSize + 1));
+    }
+
+    /**
+     * Bit b is set if entity 64 * word + b has a component.
+     * This is a single load when PageSize is a multiple of 64.
+     */
+    template<std::same_as<T> T2 = T>
+    inline std::uint64_t presenceWord(std::size_t word) const;
+
+    /**
+     * Call f with the id of every slot that differs from other, until f returns false.
+     * Pages missing from both stores are skipped without looking at their slots.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const paged_store& other, F f) const;
+
+    inline bool operator==(const paged_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    inline memory_usage memoryUsage() const;
+
+  private:
+    inline const std::optional<ElementType> *slot(EntityId id) const {
+      const auto p = id / PageSize;
+      if(p >= pages.size() || !pages[p]) {
+        return nullptr;
+      }
+      const auto& s = pages[p]->slots[id % PageSize];
+      return s ? &s : nullptr;
+    }
+
+    template<typename Value>
+    inline void emplace(EntityId id, Value&& value) {
+      resizeToFit(id);
+      auto& p = pages[id / PageSize];
+      if(!p) {
+        p = std::make_unique<page>();
+      }
+      auto& s = p->slots[id % PageSize];
+      if(!s) {
+        ++p->occupied;
+        p->presence[id % PageSize / 64] |= std::uint64_t{1} << (id % PageSize % 64);
+      }
+      s.emplace(std::forward<Value>(value));
+    }
+  };
+
+  template<typename T, std::size_t PageSize>
+  template<std::same_as<T> T2>
+  inline void paged_store<T, PageSize>::removeComponent(EntityId id) {
+    const auto p = id / PageSize;
+    if(p >= pages.size() || !pages[p]) {
+      return;
+    }
+    auto& s = pages[p]->slots[id % PageSize];
+    if(!s) {
+      return;
+    }
+    s.reset();
+    pages[p]->presence[id % PageSize / 64] &= ~(std::uint64_t{1} << (id % PageSize % 64));
+    if(--pages[p]->occupied == 0) {
+      pages[p].reset();
+    }
+  }
+
+  template<typename T, std::size_t PageSize>
+  template<std::same_as<T> T2>
+  inline std::uint64_t paged_store<T, PageSize>::presenceWord(std::size_t word) const {
+    if constexpr(PageSize % 64 == 0) {
+      const auto p = word * 64 / PageSize;
+      if(p >= pages.size() || !pages[p]) {
+        return 0;
+      }
+      return pages[p]->presence[word * 64 % PageSize / 64];
+    }
+    else {
+      std::uint64_t bits = 0;
+      for(std::size_t b = 0; b < 64; ++b) {
+        if(hasComponent(word * 64 + b)) {
+          bits |= std::uint64_t{1} << b;
+        }
+      }
+      return bits;
+    }
+  }
+
+  template<typename T, std::size_t PageSize>
+  template<std::invocable<EntityId> F>
+  inline bool paged_store<T, PageSize>::forEachDifference(const paged_store& other, F f) const {
+    const auto count = std::max(pages.size(), other.pages.size());
+    const std::optional<ElementType> empty;
+    for(std::size_t p = 0; p < count; ++p) {
+      const page *mine = p < pages.size() ? pages[p].get() : nullptr;
+      const page *theirs = p < other.pages.size() ? other.pages[p].get() : nullptr;
+      if(mine == nullptr && theirs == nullptr) {
+        continue;
+      }
+      for(std::size_t i = 0; i < PageSize; ++i) {
+        const auto& a = mine ? mine->slots[i] : empty;
+        const auto& b = theirs ? theirs->slots[i] : empty;
+        if(a != b && !detail::visitDifference(f, p * PageSize + i)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  template<typename T, std::size_t PageSize>
+  inline memory_usage paged_store<T, PageSize>::memoryUsage() const {
+    memory_usage usage;
+    usage.allocatedBytes = pages.capacity() * sizeof(std::unique_ptr<page>);
+    for(const auto& p : pages) {
+      if(p) {
+        usage.allocatedBytes += sizeof(page);
+        usage.slots += PageSize;
+        usage.occupiedSlots += p->occupied;
+      }
+    }
+    usage.liveBytes = usage.occupiedSlots * sizeof(T);
+    return usage;
+  }
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "fecs/profile.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fecs {
+  /**
+   * A group of hardware performance counters for the calling thread, read through Linux's perf_event_open.
+   *
+   * Counting only covers user space.
+   * On other platforms, or when perf events are not permitted (see /proc/sys/kernel/perf_event_paranoid),
+   * available() is false and every reading is empty.
+   */
+  class perf_counters {
+    static constexpr std::size_t counterCount = 5;
+
+    // Where each counter sits in the group read, or -1 if it could not be opened.
+    std::array<int, counterCount> slot;
+    std::array<int, counterCount> fds;
+    int leader = -1;
+    int opened = 0;
+
+  public:
+    inline perf_counters();
+    inline ~perf_counters();
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    /**
+     * The counters for the calling thread, opened on first use.
+     */
+    static inline perf_counters& forThisThread() {
+      thread_local perf_counters counters;
+      return counters;
+    }
+
+    inline bool available() const { return opened > 0; }
+
+    /**
+     * Reset the counters to zero and start counting.
+     */
+    inline void start();
+
+    /**
+     * Stop counting and get the counts since start().
+     */
+    inline hardware_counters stop();
+  };
+
+#ifdef __linux__
+  inline perf_counters::perf_counters() {
+    slot.fill(-1);
+    fds.fill(-1);
+    const std::array<std::pair<std::uint32_t, std::uint64_t>, counterCount> events{{
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {
+        PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D |
+          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+      },
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+    for(std::size_t i = 0; i < counterCount; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = events[i].first;
+      attr.config = events[i].second;
+      attr.disabled = leader == -1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+      if(fd == -1) {
+        continue;
+      }
+      if(leader == -1) {
+        leader = fd;
+      }
+      fds[i] = fd;
+      slot[i] = opened++;
+    }
+  }
+
+  inline perf_counters::~perf_counters() {
+    for(const auto fd : fds) {
+      if(fd != -1) {
+        close(fd);
+      }
+    }
+  }
+
+  inline void perf_counters::start() {
+    if(!available()) {
+      return;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  inline hardware_counters perf_counters::stop() {
+    hardware_counters result;
+    if(!available()) {
+      return result;
+    }
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // With PERF_FORMAT_GROUP, a read gives the number of counters followed by each value.
+    std::array<std::uint64_t, counterCount + 1> buffer{};
+    const auto expected = static_cast<ssize_t>(sizeof(std::uint64_t) * (opened + 1));
+    if(read(leader, buffer.data(), sizeof(buffer)) < expected) {
+      return result;
+    }
+    auto value = [&](std::size_t counter) -> std::optional<std::uint64_t> {
+      if(slot[counter] == -1) {
+        return std::nullopt;
+      }
+      return buffer[slot[counter] + 1];
+    };
+    result.cycles = value(0);
+    result.instructions = value(1);
+    result.l1dMisses = value(2);
+    result.llcMisses = value(3);
+    result.branchMisses = value(4);
+    return result;
+  }
+#else
+  inline perf_counters::perf_counters() {
+    slot.fill(-1);
+    fds.fill(-1);
+  }
+
+  inline perf_counters::~perf_counters() {}
+
+  inline void perf_counters::start() {}
+
+  inline hardware_counters perf_counters::stop() { return {}; }
+#endif
+
+  namespace detail {
+    inline void startCounters() {
+      perf_counters::forThisThread().start();
+    }
+
+    inline hardware_counters stopCounters() {
+      return perf_counters::forThisThread().stop();
+    }
+  }
+}
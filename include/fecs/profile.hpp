@@ -0,0 +1,271 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <functional>
+#include <vector>
+
+/**
+ * Opt-in instrumentation for mapEntities.
+ *
+ * Configure with -DFECS_ENABLE_PROFILING=ON, which defines FECS_ENABLE_PROFILING for the whole build,
+ * and give your systems names:
+ *
+ * ```cpp
+ * fecs::mapEntities<Position, Velocity>(world, "movement", move);
+ * fecs::profiler::instance().writeChromeTrace(file);
+ * ```
+ *
+ * Without it, the named overloads just call the plain ones, no counting code is generated,
+ * and fecs/world.hpp doesn't include this header.
+ *
+ * Additionally configuring with -DFECS_ENABLE_PERF_COUNTERS=ON samples hardware counters around each named call
+ * on Linux (see fecs::perf_counters).
+ *
+ * Both change the bodies of inline functions, so they must be the same in every translation unit of a program;
+ * don't define them in a single source file.
+ */
+
+namespace fecs {
+  /**
+   * What a single mapEntities call did.
+   */
+  struct map_stats {
+    std::uint64_t visited = 0;
+    std::uint64_t matched = 0;
+    /**
+     * Components the mapper's results added or replaced.
+     * This is 0 for void mappers, counts every element of a tuple, and doesn't count empty optionals,
+     * which remove a component instead.
+     */
+    std::uint64_t written = 0;
+
+    inline void visit() { ++visited; }
+    inline void match() { ++matched; }
+    inline void write(std::uint64_t components) { written += components; }
+  };
+
+  /**
+   * Hardware counter readings over some span of code.
+   * A counter is empty if the CPU, kernel or permissions don't allow measuring it.
+   */
+  struct hardware_counters {
+    std::optional<std::uint64_t> cycles;
+    std::optional<std::uint64_t> instructions;
+    std::optional<std::uint64_t> l1dMisses;
+    std::optional<std::uint64_t> llcMisses;
+    std::optional<std::uint64_t> branchMisses;
+
+    inline hardware_counters& operator+=(const hardware_counters& other) {
+      add(cycles, other.cycles);
+      add(instructions, other.instructions);
+      add(l1dMisses, other.l1dMisses);
+      add(llcMisses, other.llcMisses);
+      add(branchMisses, other.branchMisses);
+      return *this;
+    }
+
+    bool operator==(const hardware_counters&) const = default;
+
+  private:
+    static inline void add(
+        std::optional<std::uint64_t>& total,
+        const std::optional<std::uint64_t>& value
+    ) {
+      if(value) {
+        total = total.value_or(0) + *value;
+      }
+    }
+  };
+
+  /**
+   * Collects timings of named mapEntities calls.
+   * Recording is thread-safe.
+   *
+   * Totals are kept for the life of the profiler, but only the most recent calls are kept as trace events
+   * (see setEventLimit), and writeChromeTrace hands them over rather than keeping them.
+   */
+  class profiler {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Totals for every call made under one name.
+     */
+    struct system_totals {
+      std::uint64_t calls = 0;
+      std::chrono::nanoseconds time{0};
+      map_stats stats;
+      hardware_counters counters;
+    };
+
+    static inline profiler& instance() {
+      static profiler p;
+      return p;
+    }
+
+    inline void record(
+        const char *name,
+        clock::time_point start,
+        clock::time_point end,
+        const map_stats& stats,
+        const hardware_counters& counters = {}
+    );
+
+    /**
+     * Totals per system name, sorted by name.
+     */
+    inline std::map<std::string, system_totals> totals() const {
+      std::lock_guard lock{mutex};
+      return byName;
+    }
+
+    /**
+     * Write every call recorded since the last trace in the Chrome trace-event format,
+     * which chrome://tracing and Perfetto can open directly, then forget them.
+     */
+    inline void writeChromeTrace(std::ostream& out);
+
+    /**
+     * Keep at most `limit` trace events, dropping the oldest first. The default is 65536.
+     */
+    inline void setEventLimit(std::size_t limit) {
+      std::lock_guard lock{mutex};
+      eventLimit = limit;
+      while(events.size() > eventLimit) {
+        events.pop_front();
+      }
+    }
+
+    inline void reset() {
+      std::lock_guard lock{mutex};
+      events.clear();
+      byName.clear();
+    }
+
+  private:
+    struct event {
+      // Points at the key in byName, so names outlive the strings callers passed in.
+      const std::string *name;
+      clock::time_point start;
+      clock::time_point end;
+      std::size_t thread;
+      map_stats stats;
+      hardware_counters counters;
+    };
+
+    mutable std::mutex mutex;
+    clock::time_point epoch = clock::now();
+    std::deque<event> events;
+    std::size_t eventLimit = 65536;
+    std::map<std::string, system_totals> byName;
+  };
+
+  inline void profiler::record(
+      const char *name,
+      clock::time_point start,
+      clock::time_point end,
+      const map_stats& stats,
+      const hardware_counters& counters
+  ) {
+    const auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    std::lock_guard lock{mutex};
+    auto& [key, totals] = *byName.try_emplace(name).first;
+    if(eventLimit > 0) {
+      if(events.size() == eventLimit) {
+        events.pop_front();
+      }
+      events.push_back({&key, start, end, thread, stats, counters});
+    }
+    totals.calls += 1;
+    totals.time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    totals.stats.visited += stats.visited;
+    totals.stats.matched += stats.matched;
+    totals.stats.written += stats.written;
+    totals.counters += counters;
+  }
+
+  inline void profiler::writeChromeTrace(std::ostream& out) {
+    using micros = std::chrono::duration<double, std::micro>;
+    auto writeCounter = [&](const char *name, const std::optional<std::uint64_t>& value) {
+      if(value) {
+        out << ",\"" << name << "\":" << *value;
+      }
+    };
+    std::lock_guard lock{mutex};
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for(const auto& e : events) {
+      if(!first) {
+        out << ",";
+      }
+      first = false;
+      // System names are expected to be plain identifiers, so they are not escaped.
+      out << "{\"name\":\"" << *e.name << "\""
+          << ",\"cat\":\"fecs\",\"ph\":\"X\",\"pid\":0"
+          << ",\"tid\":" << e.thread
+          << ",\"ts\":" << micros(e.start - epoch).count()
+          << ",\"dur\":" << micros(e.end - e.start).count()
+          << ",\"args\":{\"visited\":" << e.stats.visited
+          << ",\"matched\":" << e.stats.matched
+          << ",\"written\":" << e.stats.written;
+      writeCounter("cycles", e.counters.cycles);
+      writeCounter("instructions", e.counters.instructions);
+      writeCounter("l1dMisses", e.counters.l1dMisses);
+      writeCounter("llcMisses", e.counters.llcMisses);
+      writeCounter("branchMisses", e.counters.branchMisses);
+      out << "}}";
+    }
+    out << "]}";
+    events.clear();
+  }
+
+  namespace detail {
+#ifdef FECS_ENABLE_PERF_COUNTERS
+    // Defined in fecs/perf_counters.hpp, which is included below.
+    inline void startCounters();
+    inline hardware_counters stopCounters();
+#endif
+
+    /**
+     * Measures one named mapEntities call from construction to destruction.
+     */
+    class profile_scope {
+      const char *name;
+      profiler::clock::time_point start;
+
+    public:
+      map_stats stats;
+
+      inline explicit profile_scope(const char *name) : name(name) {
+#ifdef FECS_ENABLE_PERF_COUNTERS
+        startCounters();
+#endif
+        start = profiler::clock::now();
+      }
+
+      inline ~profile_scope() {
+        const auto end = profiler::clock::now();
+#ifdef FECS_ENABLE_PERF_COUNTERS
+        profiler::instance().record(name, start, end, stats, stopCounters());
+#else
+        profiler::instance().record(name, start, end, stats);
+#endif
+      }
+
+      profile_scope(const profile_scope&) = delete;
+      profile_scope& operator=(const profile_scope&) = delete;
+    };
+  }
+}
+
+#ifdef FECS_ENABLE_PERF_COUNTERS
+#include "fecs/perf_counters.hpp"
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+#include "fecs/world.hpp"
+#include "fecs/concepts.hpp"
+#include "fecs/executor.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace fecs {
+  template<
+    typename ...Args,
+    typename T,
+    typename Function,
+    typename Combine,
+    typename World
+  > requires
+    (concepts::GetUnsafeContainer<World, Args> && ...) &&
+    std::convertible_to<std::invoke_result_t<Function&, T, const Args&...>, T> &&
+    std::convertible_to<std::invoke_result_t<Combine&, T, T>, T>
+  /**
+   * Fold every entity that has all of Args into one value, in parallel.
+   *
+   * The id range is cut into chunks of about equal work, which only depend on the world's contents,
+   * and are run on a fecs::work_stealing_executor.
+   * Each chunk folds its entities into its own partial result,
+   * starting from `init`, with `acc = f(acc, args...)`.
+   * The partials are then joined in chunk order with `combine`.
+   * So `init` should be an identity of `combine` (like 0 for +), and `combine` should be associative.
+   * As long as it is, the result is the same on every machine, even for floating point.
+   *
+   * ```cpp
+   * auto total = fecs::reduce<Health>(w, 0, [](int acc, Health h) { return acc + h.value; }, std::plus<>{});
+   * ```
+   *
+   * f and combine run on several threads at once, so they must not write to shared state.
+   */
+  inline T reduce(const World& w, T init, Function f, Combine combine) {
+    const auto chunks = detail::planChunks<Args...>(w);
+    std::vector<std::optional<T>> partials(chunks.size());
+    detail::forEachChunk(chunks, [&](std::size_t chunk, detail::id_range range) {
+      T acc = init;
+      auto visit = [&](EntityId i) {
+        if(w.template hasAllComponents<Args...>(i)) {
+          acc = f(std::move(acc), w.template getUnsafe<Args>(i)...);
+        }
+      };
+      detail::forEachCandidate<Args...>(w, range, visit);
+      partials[chunk] = std::move(acc);
+    });
+    T result = std::move(init);
+    for(auto& partial : partials) {
+      result = combine(std::move(result), std::move(*partial));
+    }
+    return result;
+  }
+
+  /**
+   * The number of entities that have all of Args.
+   */
+  template<typename ...Args, typename World>
+    requires (concepts::GetUnsafeContainer<World, Args> && ...)
+  inline std::size_t count(const World& w) {
+    return reduce<Args...>(w, std::size_t{0}, [](std::size_t n, const Args&...) { return n + 1; }, std::plus<>{});
+  }
+
+  /**
+   * The sum of every T component.
+   */
+  template<typename T, typename World>
+    requires concepts::GetUnsafeContainer<World, T>
+  inline T sum(const World& w) {
+    return reduce<T>(w, T{}, [](T acc, const T& value) { return acc + value; }, std::plus<>{});
+  }
+
+  /**
+   * The smallest T component, or std::nullopt if no entity has one.
+   */
+  template<typename T, typename World>
+    requires concepts::GetUnsafeContainer<World, T>
+  inline std::optional<T> minimum(const World& w) {
+    auto smaller = [](std::optional<T> a, const std::optional<T>& b) {
+      return b && (!a || *b < *a) ? b : a;
+    };
+    return reduce<T>(w, std::optional<T>{}, smaller, smaller);
+  }
+
+  /**
+   * The largest T component, or std::nullopt if no entity has one.
+   */
+  template<typename T, typename World>
+    requires concepts::GetUnsafeContainer<World, T>
+  inline std::optional<T> maximum(const World& w) {
+    auto larger = [](std::optional<T> a, const std::optional<T>& b) {
+      return b && (!a || *a < *b) ? b : a;
+    };
+    return reduce<T>(w, std::optional<T>{}, larger, larger);
+  }
+
+  template<
+    typename Key,
+    typename ...Args,
+    typename T,
+    typename Function,
+    typename Combine,
+    typename World
+  > requires
+    concepts::GetUnsafeContainer<World, Key> &&
+    (concepts::GetUnsafeContainer<World, Args> && ...) &&
+    std::convertible_to<std::invoke_result_t<Function&, T, const Args&...>, T> &&
+    std::convertible_to<std::invoke_result_t<Combine&, T, T>, T>
+  /**
+   * Like reduce, but with a separate result for every distinct Key component,
+   * such as the total damage dealt per team:
+   *
+   * ```cpp
+   * auto damage = fecs::groupBy<Team, Damage>(w, 0, [](int acc, Damage d) { return acc + d.amount; }, std::plus<>{});
+   * ```
+   *
+   * Only entities with Key and all of Args are counted.
+   * Every chunk builds its own hash table, and the tables are merged in chunk order,
+   * so the same rules about `init` and `combine` apply, and so does the repeatability.
+   */
+  inline std::unordered_map<Key, T> groupBy(const World& w, T init, Function f, Combine combine) {
+    const auto chunks = detail::planChunks<Key, Args...>(w);
+    std::vector<std::unordered_map<Key, T>> partials(chunks.size());
+    detail::forEachChunk(chunks, [&](std::size_t chunk, detail::id_range range) {
+      auto& groups = partials[chunk];
+      auto visit = [&](EntityId i) {
+        if(w.template hasAllComponents<Key, Args...>(i)) {
+          auto& acc = groups.try_emplace(w.template getUnsafe<Key>(i), init).first->second;
+          acc = f(std::move(acc), w.template getUnsafe<Args>(i)...);
+        }
+      };
+      detail::forEachCandidate<Key, Args...>(w, range, visit);
+    });
+    std::unordered_map<Key, T> result;
+    for(auto& groups : partials) {
+      for(auto& [key, partial] : groups) {
+        auto& acc = result.try_emplace(key, init).first->second;
+        acc = combine(std::move(acc), std::move(partial));
+      }
+    }
+    return result;
+  }
+}
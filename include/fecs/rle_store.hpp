@@ -0,0 +1,377 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace fecs {
+  template<typename T>
+  /**
+   * A run-length encoded store, for components like `Team` or `ZoneId`
+   * that are identical across long ranges of consecutive ids.
+   *
+   * Components are kept as sorted (start, length, value) runs, and neighbouring runs with equal values are always merged,
+   * so a million entities on one team are a single run.
+   * Lookups are a binary search over runs.
+   *
+   * Writes that don't change the shape of the run list are O(log runs): rewriting a whole run, writing the value
+   * a run already has, or growing a run at either end (which is also how a write joins an equal neighbour).
+   * Otherwise a write inserts or erases at most two runs in one go.
+   *
+   * Use fecs::mapRuns to call a mapper once per run instead of once per entity.
+   */
+  class rle_store {
+    using ElementType = T;
+
+  public:
+    struct run {
+      EntityId start;
+      EntityId length;
+      ElementType value;
+
+      inline EntityId end() const { return start + length; }
+
+      bool operator==(const run&) const = default;
+    };
+
+  private:
+    std::vector<run> runs;
+
+  public:
+    using ComponentType = T;
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return find(id) != nullptr;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(const auto r = find(id)) {
+        return r->value;
+      }
+      return std::nullopt;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return find(id)->value;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp) {
+      setRange(id, 1, std::optional<ElementType>{std::move(comp)});
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      setRange(id, 1, std::optional<ElementType>{std::forward<T2&&>(c)});
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id) {
+      setRange(id, 1, std::nullopt);
+    }
+
+    inline void resizeToFit(EntityId) {}
+
+    /**
+     * Give every id in [start, start + length) the same value, or remove it from all of them.
+     */
+    inline void setRange(EntityId start, EntityId length, const std::optional<ElementType>& value);
+
+    /**
+     * The runs, sorted by start.
+     */
+    inline const std::vector<run>& allRuns() const { return runs; }
+
+    /**
+     * Replace every run's value with f(value), or drop the run if f returns std::nullopt,
+     * rebuilding the run list in one linear pass.
+     * f is called once per run, in order.
+     */
+    template<typename F>
+      requires std::convertible_to<std::invoke_result_t<F&, const ElementType&>, std::optional<ElementType>>
+    inline void transformRuns(F f);
+
+    template<std::invocable<EntityId> F>
+    inline void forEachDifference(const rle_store& other, F f) const;
+
+    /**
+     * Runs are always merged, so equal stores have identical run lists.
+     */
+    bool operator==(const rle_store&) const = default;
+
+    inline memory_usage memoryUsage() const {
+      std::size_t covered = 0;
+      for(const auto& r : runs) {
+        covered += r.length;
+      }
+      return {
+        .allocatedBytes = runs.capacity() * sizeof(run),
+        .liveBytes = runs.size() * sizeof(ElementType),
+        .slots = covered,
+        .occupiedSlots = covered,
+      };
+    }
+
+  private:
+    inline const run *find(EntityId id) const {
+      auto it = std::upper_bound(
+        runs.begin(),
+        runs.end(),
+        id,
+        [](EntityId i, const run& r) { return i < r.start; }
+      );
+      if(it == runs.begin()) {
+        return nullptr;
+      }
+      --it;
+      return id < it->end() ? &*it : nullptr;
+    }
+
+    // Whether runs[i] exists and ends right where `start` begins with the same value.
+    inline bool joinsBefore(std::size_t i, EntityId start, const ElementType& value) const {
+      return i < runs.size() && runs[i].end() == start && runs[i].value == value;
+    }
+
+    // Whether runs[i] exists and starts right where `end` finishes with the same value.
+    inline bool joinsAfter(std::size_t i, EntityId end, const ElementType& value) const {
+      return i < runs.size() && runs[i].start == end && runs[i].value == value;
+    }
+  };
+
+  template<typename T>
+  inline void rle_store<T>::setRange(
+      EntityId start,
+      EntityId length,
+      const std::optional<ElementType>& value
+  ) {
+    if(length == 0) {
+      return;
+    }
+    const auto end = start + length;
+
+    // The first run that isn't entirely before the range.
+    const std::size_t i = std::partition_point(runs.begin(), runs.end(), [&](const run& r) {
+      return r.end() <= start;
+    }) - runs.begin();
+    const auto at = [&](std::size_t k) { return runs.begin() + static_cast<std::ptrdiff_t>(k); };
+    // Indices below 0 wrap around, which joinsBefore treats as a missing run.
+    const auto before = i - 1;
+
+    // The range is a gap between runs: grow a neighbour into it if we can, otherwise insert one run.
+    if(i == runs.size() || runs[i].start >= end) {
+      if(!value) {
+        return;
+      }
+      const bool joinPrev = joinsBefore(before, start, *value);
+      const bool joinNext = joinsAfter(i, end, *value);
+      if(joinPrev && joinNext) {
+        runs[before].length += length + runs[i].length;
+        runs.erase(at(i));
+      }
+      else if(joinPrev) {
+        runs[before].length += length;
+      }
+      else if(joinNext) {
+        runs[i].start = start;
+        runs[i].length += length;
+      }
+      else {
+        runs.insert(at(i), run{start, length, *value});
+      }
+      return;
+    }
+
+    // The range lies within one run: rewrite it in place, growing a neighbour or splitting off what's left.
+    if(runs[i].start <= start && end <= runs[i].end()) {
+      auto& r = runs[i];
+      if(value && r.value == *value) {
+        return;
+      }
+      const bool keepLeft = r.start < start;
+      const bool keepRight = end < r.end();
+      if(keepLeft && keepRight) {
+        run right{end, r.end() - end, r.value};
+        r.length = start - r.start;
+        if(value) {
+          runs.insert(at(i + 1), {run{start, length, *value}, std::move(right)});
+        }
+        else {
+          runs.insert(at(i + 1), std::move(right));
+        }
+        return;
+      }
+      if(!value) {
+        if(keepLeft) {
+          r.length = start - r.start;
+        }
+        else if(keepRight) {
+          r.start = end;
+          r.length -= length;
+        }
+        else {
+          runs.erase(at(i));
+        }
+        return;
+      }
+      const bool joinPrev = !keepLeft && joinsBefore(before, start, *value);
+      const bool joinNext = !keepRight && joinsAfter(i + 1, end, *value);
+      if(!keepLeft && !keepRight) {
+        if(joinPrev && joinNext) {
+          runs[before].length += length + runs[i + 1].length;
+          runs.erase(at(i), at(i + 2));
+        }
+        else if(joinPrev) {
+          runs[before].length += length;
+          runs.erase(at(i));
+        }
+        else if(joinNext) {
+          runs[i + 1].start = start;
+          runs[i + 1].length += length;
+          runs.erase(at(i));
+        }
+        else {
+          r.value = *value;
+        }
+      }
+      else if(keepRight) {
+        r.start = end;
+        r.length -= length;
+        if(joinPrev) {
+          runs[before].length += length;
+        }
+        else {
+          runs.insert(at(i), run{start, length, *value});
+        }
+      }
+      else {
+        r.length -= length;
+        if(joinNext) {
+          runs[i + 1].start = start;
+          runs[i + 1].length += length;
+        }
+        else {
+          runs.insert(at(i + 1), run{start, length, *value});
+        }
+      }
+      return;
+    }
+
+    // The range covers parts of several runs: trim the ends, then replace everything between with one run.
+    auto first = at(i);
+    if(first->start < start) {
+      first->length = start - first->start;
+      ++first;
+    }
+    auto last = first;
+    while(last != runs.end() && last->end() <= end) {
+      ++last;
+    }
+    if(last != runs.end() && last->start < end) {
+      last->length -= end - last->start;
+      last->start = end;
+    }
+    const std::size_t index = first - runs.begin();
+    if(!value) {
+      runs.erase(first, last);
+      return;
+    }
+    // Fold equal neighbours into the new run before it goes in.
+    run merged{start, length, *value};
+    auto eraseFrom = first;
+    auto eraseTo = last;
+    if(joinsBefore(index - 1, start, *value)) {
+      --eraseFrom;
+      merged.start = eraseFrom->start;
+      merged.length += eraseFrom->length;
+    }
+    if(eraseTo != runs.end() && eraseTo->start == end && eraseTo->value == *value) {
+      merged.length += eraseTo->length;
+      ++eraseTo;
+    }
+    if(eraseFrom == eraseTo) {
+      runs.insert(eraseFrom, std::move(merged));
+    }
+    else {
+      *eraseFrom = std::move(merged);
+      runs.erase(eraseFrom + 1, eraseTo);
+    }
+  }
+
+  template<typename T>
+  template<typename F>
+    requires std::convertible_to<std::invoke_result_t<F&, const T&>, std::optional<T>>
+  inline void rle_store<T>::transformRuns(F f) {
+    std::vector<run> rebuilt;
+    rebuilt.reserve(runs.size());
+    for(const auto& r : runs) {
+      std::optional<ElementType> value = f(r.value);
+      if(!value) {
+        continue;
+      }
+      if(!rebuilt.empty() && rebuilt.back().end() == r.start && rebuilt.back().value == *value) {
+        rebuilt.back().length += r.length;
+      }
+      else {
+        rebuilt.push_back(run{r.start, r.length, std::move(*value)});
+      }
+    }
+    runs = std::move(rebuilt);
+  }
+
+  template<typename T>
+  template<std::invocable<EntityId> F>
+  inline void rle_store<T>::forEachDifference(const rle_store& other, F f) const {
+    // Between two consecutive run boundaries neither store changes value,
+    // so each segment needs only one comparison.
+    std::vector<EntityId> bounds;
+    bounds.reserve((runs.size() + other.runs.size()) * 2);
+    for(const auto *store : {this, &other}) {
+      for(const auto& r : store->runs) {
+        bounds.push_back(r.start);
+        bounds.push_back(r.end());
+      }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    for(std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+      const auto mine = find(bounds[b]);
+      const auto theirs = other.find(bounds[b]);
+      const bool same = mine == nullptr || theirs == nullptr
+        ? mine == theirs
+        : mine->value == theirs->value;
+      if(!same) {
+        for(EntityId id = bounds[b]; id < bounds[b + 1]; ++id) {
+          f(id);
+        }
+      }
+    }
+  }
+
+  template<
+    typename T,
+    typename Function,
+    typename World
+  > requires requires(World& w, std::optional<T> (*f)(const T&)) {
+      { w.template store<T>().transformRuns(f) };
+    } &&
+    std::convertible_to<std::invoke_result_t<Function, const T&>, std::optional<T>>
+  /**
+   * Like mapEntities<T>, but for a component in an rle_store:
+   * the mapper is called *once per run* and the run list is rebuilt from the results in one pass.
+   *
+   * By using this you're promising that the mapper is pure, so calling it once per run gives the same result
+   * as calling it for every entity.
+   * Returning std::nullopt removes the component from the whole run.
+   */
+  inline void mapRuns(World& w, Function f) {
+    w.template store<T>().transformRuns(f);
+  }
+}
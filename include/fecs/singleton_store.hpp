@@ -0,0 +1,87 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <concepts>
+#include <optional>
+#include <utility>
+
+namespace fecs {
+  template<typename T>
+  /**
+   * A store for world-global data, like the frame's delta time, RNG state, or config.
+   *
+   * Every entity "has" the one shared value, so mappers can simply take it as an argument:
+   *
+   * ```cpp
+   * fecs::mapEntities<Position, Velocity, DeltaTime>(w, [](Position p, Velocity v, DeltaTime dt) -> Position { ... });
+   * ```
+   *
+   * Since getUnsafe ignores the id and hands back the same reference, the compiler can hoist the read out of the loop.
+   * Writing it through *any* entity id replaces the shared value.
+   * It can't be removed, so mappers can't return a std::optional of it.
+   */
+  class singleton_store {
+    using ElementType = T;
+    ElementType value{};
+
+  public:
+    using ComponentType = T;
+
+    /**
+     * Every id reads and writes the same slot (hashed_store hashes it as entity 0).
+     */
+    static constexpr bool sharedSlot = true;
+
+    singleton_store() = default;
+
+    explicit singleton_store(T initial) : value(std::move(initial)) {}
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId) const { return true; }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId) const { return value; }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId) const { return value; }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId, T2 comp) { value = std::move(comp); }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId, T2&& c) { value = std::forward<T2&&>(c); }
+
+    template<std::same_as<T> T2 = T>
+    void removeComponent(EntityId) = delete;
+
+    inline void resizeToFit(EntityId) {}
+
+    /**
+     * The shared value.
+     */
+    inline const ElementType& get() const { return value; }
+
+    inline void set(T newValue) { value = std::move(newValue); }
+
+    /**
+     * A changed value is reported against entity 0, so diffs and deltas carry it along.
+     */
+    template<std::invocable<EntityId> F>
+    inline void forEachDifference(const singleton_store& other, F f) const {
+      if(!(value == other.value)) {
+        f(0);
+      }
+    }
+
+    bool operator==(const singleton_store&) const = default;
+
+    inline memory_usage memoryUsage() const {
+      return {
+        .allocatedBytes = sizeof(T),
+        .liveBytes = sizeof(T),
+        .slots = 1,
+        .occupiedSlots = 1,
+      };
+    }
+  };
+}
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace fecs {
+  /**
+   * Reads a 2D position from a component with `x` and `y` members.
+   * Pass your own function object to spatial_store if your component looks different.
+   */
+  struct xy_position {
+    template<typename T>
+    inline std::array<float, 2> operator()(const T& t) const {
+      return { static_cast<float>(t.x), static_cast<float>(t.y) };
+    }
+  };
+
+  template<typename T, typename PositionOf = xy_position>
+  /**
+   * A store that keeps its components in a uniform 2D grid as well as by id,
+   * so systems can ask for "everything near here" without comparing every pair of entities.
+   *
+   * Because components are *replaced* rather than mutated, every move goes through addComponent,
+   * which is where the grid gets updated.
+   * Access the queries from a system through world::store:
+   *
+   * ```cpp
+   * const auto& bodies = w.store<Body>();
+   * fecs::mapEntities<Body>(w, [&](const Body& b) -> void {
+   *   bodies.forEachInRadius(b.x, b.y, 10.0f, [&](EntityId other, const Body& o) { ... });
+   * });
+   * ```
+   *
+   * If a mapper writes this component while another reads neighbours, the neighbours may already be updated;
+   * use fecs::double_buffered if that matters.
+   *
+   * Positions beyond the grid's int32 cell range land in its outermost cells.
+   * Adding a component whose position is NaN throws std::invalid_argument.
+   */
+  class spatial_store {
+    using ElementType = T;
+    using CellKey = std::uint64_t;
+
+    std::vector<std::optional<ElementType>> elements;
+    std::vector<CellKey> cellOf;
+    std::unordered_map<CellKey, std::vector<EntityId>> cells;
+    float cellSize = 16.0f;
+    std::size_t count = 0;
+
+  public:
+    using ComponentType = T;
+
+    spatial_store() = default;
+
+    /**
+     * Queries look at every cell a search radius touches, so a cell size close to your usual
+     * query radius works best.
+     */
+    explicit spatial_store(float cellSize) : cellSize(cellSize) {}
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return id < elements.size() && elements[id].has_value();
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(id >= elements.size()) {
+        return std::nullopt;
+      }
+      return elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp);
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, std::forward<T2&&>(c));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id);
+
+    inline void resizeToFit(EntityId id) {
+      elements.resize(std::max(elements.size(), id + 1));
+      cellOf.resize(elements.size());
+    }
+
+    /**
+     * Call f(id, component) for every component within `radius` of (x, y).
+     * If the radius covers more cells than are occupied, this scans the occupied cells instead.
+     */
+    template<std::invocable<EntityId, const ElementType&> F>
+    inline void forEachInRadius(float x, float y, float radius, F f) const;
+
+    /**
+     * The closest component to (x, y) that is at most maxDistance away, skipping `ignore` (usually the asking entity).
+     *
+     * This searches rings of cells outwards from (x, y),
+     * and falls back to scanning the occupied cells once the rings would cover more cells than that.
+     */
+    inline std::optional<EntityId> nearest(
+        float x,
+        float y,
+        float maxDistance = std::numeric_limits<float>::infinity(),
+        std::optional<EntityId> ignore = std::nullopt
+    ) const;
+
+    /**
+     * Call f with the id of every slot that differs from other, until f returns false.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const spatial_store& other, F f) const {
+      return detail::forEachSlotDifference(elements, other.elements, f);
+    }
+
+    /**
+     * Stores are equal if they hold the same components; the grid is just an index.
+     */
+    inline bool operator==(const spatial_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    inline memory_usage memoryUsage() const;
+
+  private:
+    // The cell column or row holding v, clamped to the int32 range. v must not be NaN.
+    inline std::int64_t cellCoord(float v) const {
+      constexpr auto low = static_cast<double>(std::numeric_limits<std::int32_t>::min());
+      constexpr auto high = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+      return static_cast<std::int64_t>(std::clamp(std::floor(static_cast<double>(v) / cellSize), low, high));
+    }
+
+    static inline bool inGrid(std::int64_t c) {
+      return c >= std::numeric_limits<std::int32_t>::min() && c <= std::numeric_limits<std::int32_t>::max();
+    }
+
+    static inline CellKey key(std::int64_t cx, std::int64_t cy) {
+      return (static_cast<CellKey>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+    }
+
+    inline CellKey keyOf(const ElementType& value) const {
+      const auto [x, y] = PositionOf{}(value);
+      if(std::isnan(x) || std::isnan(y)) {
+        throw std::invalid_argument("fecs::spatial_store can't place a component at a NaN position");
+      }
+      return key(cellCoord(x), cellCoord(y));
+    }
+
+    inline void unlink(EntityId id) {
+      auto& cell = cells[cellOf[id]];
+      const auto it = std::find(cell.begin(), cell.end(), id);
+      *it = cell.back();
+      cell.pop_back();
+      if(cell.empty()) {
+        cells.erase(cellOf[id]);
+      }
+    }
+
+    // Call f(id, squared distance) for every component in the given ids.
+    template<typename F>
+    inline void scanIds(const std::vector<EntityId>& ids, float x, float y, F& f) const {
+      for(const auto id : ids) {
+        const auto [px, py] = PositionOf{}(*elements[id]);
+        f(id, (px - x) * (px - x) + (py - y) * (py - y));
+      }
+    }
+
+    // Call f(id, squared distance) for every component in cell (cx, cy). Cells outside the grid are empty.
+    template<typename F>
+    inline void scanCell(std::int64_t cx, std::int64_t cy, float x, float y, F& f) const {
+      if(!inGrid(cx) || !inGrid(cy)) {
+        return;
+      }
+      const auto it = cells.find(key(cx, cy));
+      if(it != cells.end()) {
+        scanIds(it->second, x, y, f);
+      }
+    }
+
+    // Call f(id, squared distance) for every component, one occupied cell at a time.
+    template<typename F>
+    inline void scanOccupied(float x, float y, F& f) const {
+      for(const auto& [cell, ids] : cells) {
+        scanIds(ids, x, y, f);
+      }
+    }
+  };
+
+  template<typename T, typename PositionOf>
+  template<std::same_as<T> T2>
+  inline void spatial_store<T, PositionOf>::addComponent(EntityId id, T2 comp) {
+    resizeToFit(id);
+    const auto newKey = keyOf(comp);
+    if(elements[id]) {
+      if(cellOf[id] != newKey) {
+        unlink(id);
+        cells[newKey].push_back(id);
+      }
+    }
+    else {
+      cells[newKey].push_back(id);
+      ++count;
+    }
+    cellOf[id] = newKey;
+    elements[id] = std::move(comp);
+  }
+
+  template<typename T, typename PositionOf>
+  template<std::same_as<T> T2>
+  inline void spatial_store<T, PositionOf>::removeComponent(EntityId id) {
+    if(!hasComponent(id)) {
+      return;
+    }
+    unlink(id);
+    elements[id] = std::nullopt;
+    --count;
+  }
+
+  template<typename T, typename PositionOf>
+  template<std::invocable<EntityId, const T&> F>
+  inline void spatial_store<T, PositionOf>::forEachInRadius(float x, float y, float radius, F f) const {
+    if(std::isnan(x) || std::isnan(y) || !(radius >= 0.0f)) {
+      return;
+    }
+    const auto r2 = radius * radius;
+    auto visit = [&](EntityId id, float d2) {
+      if(d2 <= r2) {
+        f(id, *elements[id]);
+      }
+    };
+    const auto x0 = cellCoord(x - radius);
+    const auto x1 = cellCoord(x + radius);
+    const auto y0 = cellCoord(y - radius);
+    const auto y1 = cellCoord(y + radius);
+    if(static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) > static_cast<double>(cells.size())) {
+      scanOccupied(x, y, visit);
+      return;
+    }
+    for(auto cx = x0; cx <= x1; ++cx) {
+      for(auto cy = y0; cy <= y1; ++cy) {
+        scanCell(cx, cy, x, y, visit);
+      }
+    }
+  }
+
+  template<typename T, typename PositionOf>
+  inline std::optional<EntityId> spatial_store<T, PositionOf>::nearest(
+      float x,
+      float y,
+      float maxDistance,
+      std::optional<EntityId> ignore
+  ) const {
+    std::optional<EntityId> best;
+    auto bestD2 = maxDistance * maxDistance;
+    const auto available = count - (ignore && hasComponent(*ignore) ? 1 : 0);
+    if(available == 0 || std::isnan(x) || std::isnan(y)) {
+      return std::nullopt;
+    }
+    auto visit = [&](EntityId id, float d2) {
+      if(id != ignore && d2 <= bestD2) {
+        best = id;
+        bestD2 = d2;
+      }
+    };
+    const auto cx = cellCoord(x);
+    const auto cy = cellCoord(y);
+    // Everything outside ring k is at least k cells away, so we can stop once the best match is closer than that.
+    for(std::int64_t k = 0; ; ++k) {
+      // Rings 0..k cover (2k + 1)^2 cells; past the number of occupied cells, visiting those directly is cheaper.
+      if(static_cast<std::size_t>((2 * k + 1) * (2 * k + 1)) > cells.size()) {
+        scanOccupied(x, y, visit);
+        return best;
+      }
+      for(auto i = -k; i <= k; ++i) {
+        scanCell(cx + i, cy - k, x, y, visit);
+        if(k != 0) {
+          scanCell(cx + i, cy + k, x, y, visit);
+        }
+      }
+      for(auto j = -k + 1; j <= k - 1; ++j) {
+        scanCell(cx - k, cy + j, x, y, visit);
+        scanCell(cx + k, cy + j, x, y, visit);
+      }
+      const auto ringDistance = static_cast<float>(k) * cellSize;
+      if(ringDistance > maxDistance || (best && bestD2 <= ringDistance * ringDistance)) {
+        return best;
+      }
+    }
+  }
+
+  template<typename T, typename PositionOf>
+  inline memory_usage spatial_store<T, PositionOf>::memoryUsage() const {
+    constexpr auto nodeBytes = sizeof(void *) + sizeof(typename decltype(cells)::value_type);
+    std::size_t cellBytes = cells.bucket_count() * sizeof(void *);
+    for(const auto& [k, ids] : cells) {
+      cellBytes += nodeBytes + ids.capacity() * sizeof(EntityId);
+    }
+    return {
+      .allocatedBytes =
+        elements.capacity() * sizeof(std::optional<ElementType>) +
+        cellOf.capacity() * sizeof(CellKey) +
+        cellBytes,
+      .liveBytes = count * sizeof(ElementType),
+      .slots = elements.size(),
+      .occupiedSlots = count,
+    };
+  }
+}
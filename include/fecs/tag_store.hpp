@@ -0,0 +1,123 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace fecs {
+  template<typename T>
+    requires std::is_empty_v<T> && std::default_initializable<T>
+  /**
+   * A store for marker components with no data, like `Enemy` or `Dead`.
+   *
+   * It is just a bitset, so each entity costs one bit instead of a whole std::optional<T>.
+   * getUnsafe hands back a default-constructed T.
+   * Presence is also available 64 ids at a time through presenceWord, which world::presenceWord uses to
+   * intersect several tags with a single AND.
+   */
+  class tag_store {
+    using ElementType = T;
+    std::vector<std::uint64_t> words;
+
+  public:
+    using ComponentType = T;
+
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      const auto word = id / 64;
+      return word < words.size() && ((words[word] >> (id % 64)) & 1u);
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(hasComponent(id)) {
+        return ElementType{};
+      }
+      return std::nullopt;
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline ElementType getUnsafe(EntityId) const {
+      return ElementType{};
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2) {
+      resizeToFit(id);
+      words[id / 64] |= std::uint64_t{1} << (id % 64);
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, c);
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id) {
+      const auto word = id / 64;
+      if(word < words.size()) {
+        words[word] &= ~(std::uint64_t{1} << (id % 64));
+      }
+    }
+
+    inline void resizeToFit(EntityId id) {
+      words.resize(std::max(words.size(), id / 64 + 1));
+    }
+
+    /**
+     * Bit b is set if entity 64 * word + b has this tag.
+     */
+    template<std::same_as<T> T2 = T>
+    inline std::uint64_t presenceWord(std::size_t word) const {
+      return word < words.size() ? words[word] : 0;
+    }
+
+    /**
+     * How many entities have this tag.
+     */
+    inline std::size_t count() const {
+      std::size_t total = 0;
+      for(const auto w : words) {
+        total += static_cast<std::size_t>(std::popcount(w));
+      }
+      return total;
+    }
+
+    template<std::invocable<EntityId> F>
+    inline void forEachDifference(const tag_store& other, F f) const {
+      const auto count = std::max(words.size(), other.words.size());
+      for(std::size_t w = 0; w < count; ++w) {
+        for(auto bits = presenceWord(w) ^ other.presenceWord(w); bits != 0; bits &= bits - 1) {
+          f(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+        }
+      }
+    }
+
+    inline bool operator==(const tag_store& other) const {
+      const auto count = std::max(words.size(), other.words.size());
+      for(std::size_t w = 0; w < count; ++w) {
+        if(presenceWord(w) != other.presenceWord(w)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * Tags hold no data, so every allocated byte counts as overhead.
+     */
+    inline memory_usage memoryUsage() const {
+      return {
+        .allocatedBytes = words.capacity() * sizeof(std::uint64_t),
+        .liveBytes = 0,
+        .slots = words.size() * 64,
+        .occupiedSlots = count(),
+      };
+    }
+  };
+}
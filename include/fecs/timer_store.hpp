@@ -0,0 +1,335 @@
+#pragma once
+
+#include <fecs/concepts.hpp>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fecs {
+  /**
+   * Reads the deadline of a component with a `time` member, like `RespawnAt{time}`.
+   * Pass your own function object to timer_store if your component looks different.
+   */
+  struct time_deadline {
+    template<typename T>
+    inline auto operator()(const T& t) const {
+      return t.time;
+    }
+  };
+
+  template<typename T, typename DeadlineOf = time_deadline>
+  /**
+   * A store for components that only matter once a deadline passes, like `RespawnAt` or `CooldownUntil`.
+   *
+   * Next to the per-id slots it keeps a min-heap of deadlines,
+   * so finding everything that has expired costs O(expired) instead of a scan over every id.
+   * Replacing or removing a component leaves its old heap entry behind to be skipped later.
+   * Stale entries are popped as soon as they reach the front of the heap, consuming expired timers pops them too,
+   * and the rest are filtered out once they outnumber the live entries.
+   * See mapExpired for mapping over expired components.
+   */
+  class timer_store {
+    using ElementType = T;
+
+  public:
+    using ComponentType = T;
+    using Deadline = std::remove_cvref_t<std::invoke_result_t<DeadlineOf, const T&>>;
+
+  private:
+    struct entry {
+      Deadline deadline;
+      EntityId id;
+      std::uint32_t version;
+    };
+
+    // Orders the heap with the earliest deadline at the front.
+    struct later {
+      inline bool operator()(const entry& a, const entry& b) const {
+        return b.deadline < a.deadline;
+      }
+    };
+
+    std::vector<std::optional<ElementType>> elements;
+    // Bumped whenever a slot changes, so heap entries for an older value can be recognised.
+    std::vector<std::uint32_t> versions;
+    std::vector<entry> heap;
+    std::size_t count = 0;
+
+  public:
+    template<std::same_as<T> T2 = T>
+    inline bool hasComponent(EntityId id) const {
+      return id < elements.size() && elements[id].has_value();
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline std::optional<ElementType> getSafe(EntityId id) const {
+      if(id >= elements.size()) {
+        return std::nullopt;
+      }
+      return elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline const ElementType& getUnsafe(EntityId id) const {
+      return *elements[id];
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void addComponent(EntityId id, T2 comp) {
+      resizeToFit(id);
+      if(!elements[id]) {
+        ++count;
+      }
+      heap.push_back({DeadlineOf{}(comp), id, ++versions[id]});
+      std::push_heap(heap.begin(), heap.end(), later{});
+      elements[id] = std::move(comp);
+      dropStale();
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void moveComponent(EntityId id, T2&& c) {
+      addComponent<T2>(id, std::forward<T2&&>(c));
+    }
+
+    template<std::same_as<T> T2 = T>
+    inline void removeComponent(EntityId id) {
+      if(!hasComponent(id)) {
+        return;
+      }
+      elements[id] = std::nullopt;
+      ++versions[id];
+      --count;
+      dropStale();
+    }
+
+    inline void resizeToFit(EntityId id) {
+      elements.resize(std::max(elements.size(), id + 1));
+      versions.resize(elements.size());
+    }
+
+    /**
+     * The ids of every component whose deadline is at or before `now`,
+     * ordered by deadline and then by id.
+     *
+     * Only the expired part of the heap is visited:
+     * a subtree whose root hasn't expired yet can't contain anything that has.
+     * Since this doesn't change the heap, prefer consumeExpired (or mapExpired) every frame,
+     * which pops what it visits.
+     */
+    inline std::vector<EntityId> expired(const Deadline& now) const;
+
+    /**
+     * Call f(id) for every component whose deadline is at or before `now`, in the same order as expired(),
+     * popping their heap entries (and any stale ones on the way) instead of walking past them again next time.
+     *
+     * f may replace or remove the component, which reschedules it as usual.
+     * Components f leaves untouched are put back, so they're still expired next time.
+     */
+    template<std::invocable<EntityId> F>
+    inline void consumeExpired(const Deadline& now, F f);
+
+    /**
+     * How many entries the heap holds, including stale ones that haven't been dropped yet.
+     */
+    inline std::size_t scheduledEntries() const { return heap.size(); }
+
+    /**
+     * The earliest deadline of any component, if there are any.
+     */
+    inline std::optional<Deadline> nextDeadline() const;
+
+    /**
+     * Call f with the id of every slot that differs from other, until f returns false.
+     * Returns false if f stopped the walk.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const timer_store& other, F f) const {
+      return detail::forEachSlotDifference(elements, other.elements, f);
+    }
+
+    /**
+     * Stores are equal if they hold the same components; the heap is derived from them.
+     */
+    inline bool operator==(const timer_store& other) const {
+      return detail::noDifferences(*this, other);
+    }
+
+    inline memory_usage memoryUsage() const {
+      return {
+        .allocatedBytes =
+          elements.capacity() * sizeof(std::optional<ElementType>) +
+          versions.capacity() * sizeof(std::uint32_t) +
+          heap.capacity() * sizeof(entry),
+        .liveBytes = count * sizeof(ElementType),
+        .slots = elements.size(),
+        .occupiedSlots = count,
+      };
+    }
+
+  private:
+    inline bool isLive(const entry& e) const {
+      return elements[e.id] && versions[e.id] == e.version;
+    }
+
+    inline void popFront() {
+      std::pop_heap(heap.begin(), heap.end(), later{});
+      heap.pop_back();
+    }
+
+    inline void dropStale() {
+      while(!heap.empty() && !isLive(heap.front())) {
+        popFront();
+      }
+      // Whatever is left is buried under live entries; filter it out once it's the majority.
+      if(heap.size() > 2 * count + 64) {
+        std::erase_if(heap, [&](const entry& e) { return !isLive(e); });
+        std::make_heap(heap.begin(), heap.end(), later{});
+      }
+    }
+
+    static inline bool earlier(const entry& a, const entry& b) {
+      if(a.deadline < b.deadline) {
+        return true;
+      }
+      if(b.deadline < a.deadline) {
+        return false;
+      }
+      return a.id < b.id;
+    }
+  };
+
+  template<typename T, typename DeadlineOf>
+  inline std::vector<EntityId> timer_store<T, DeadlineOf>::expired(const Deadline& now) const {
+    std::vector<entry> found;
+    std::vector<std::size_t> pending;
+    if(!heap.empty()) {
+      pending.push_back(0);
+    }
+    while(!pending.empty()) {
+      const auto i = pending.back();
+      pending.pop_back();
+      if(now < heap[i].deadline) {
+        continue;
+      }
+      if(isLive(heap[i])) {
+        found.push_back(heap[i]);
+      }
+      for(const auto child : {2 * i + 1, 2 * i + 2}) {
+        if(child < heap.size()) {
+          pending.push_back(child);
+        }
+      }
+    }
+    std::sort(found.begin(), found.end(), earlier);
+    std::vector<EntityId> ids;
+    ids.reserve(found.size());
+    for(const auto& e : found) {
+      ids.push_back(e.id);
+    }
+    return ids;
+  }
+
+  template<typename T, typename DeadlineOf>
+  template<std::invocable<EntityId> F>
+  inline void timer_store<T, DeadlineOf>::consumeExpired(const Deadline& now, F f) {
+    std::vector<entry> due;
+    while(!heap.empty() && !(now < heap.front().deadline)) {
+      if(isLive(heap.front())) {
+        due.push_back(heap.front());
+      }
+      popFront();
+    }
+    // The heap pops in deadline order already, but ties come out in any order.
+    std::sort(due.begin(), due.end(), earlier);
+    for(const auto& e : due) {
+      f(e.id);
+    }
+    for(const auto& e : due) {
+      if(isLive(e)) {
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end(), later{});
+      }
+    }
+    dropStale();
+  }
+
+  template<typename T, typename DeadlineOf>
+  inline auto timer_store<T, DeadlineOf>::nextDeadline() const -> std::optional<Deadline> {
+    std::optional<Deadline> next;
+    std::vector<std::size_t> pending;
+    if(!heap.empty()) {
+      pending.push_back(0);
+    }
+    while(!pending.empty()) {
+      const auto i = pending.back();
+      pending.pop_back();
+      if(next && !(heap[i].deadline < *next)) {
+        continue;
+      }
+      // Children are never earlier than their parent, so a live entry ends the search below it.
+      if(isLive(heap[i])) {
+        next = heap[i].deadline;
+        continue;
+      }
+      for(const auto child : {2 * i + 1, 2 * i + 2}) {
+        if(child < heap.size()) {
+          pending.push_back(child);
+        }
+      }
+    }
+    return next;
+  }
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Time,
+    typename Function,
+    typename World
+  > requires requires(World& w, const Time& now, void (*f)(EntityId)) {
+      { w.template store<T>().consumeExpired(now, f) };
+    } &&
+    concepts::ContainerMapFunction<World, Function, T, Args...>
+  /**
+   * Like mapEntities<T, Args...>, but only visits entities whose T (which must live in a timer_store)
+   * has a deadline at or before `now`, earliest first.
+   *
+   * The mapper should usually get rid of the expired component, by removing it or returning one with a new deadline;
+   * otherwise it will still be expired on the next call.
+   */
+  inline void mapExpired(World& w, const Time& now, Function f) {
+    w.template store<T>().consumeExpired(now, [&](EntityId id) {
+      if(w.template hasAllComponents<T, Args...>(id)) {
+        w.template setMapResult<decltype(f(w.template getUnsafe<T>(id), w.template getUnsafe<Args>(id)...))>
+          (id, f(w.template getUnsafe<T>(id), w.template getUnsafe<Args>(id)...));
+      }
+    });
+  }
+
+  template<
+    typename T,
+    typename ...Args,
+    typename Time,
+    typename Function,
+    typename World
+  > requires requires(const World& w, const Time& now) {
+      { w.template store<T>().expired(now) } -> std::same_as<std::vector<EntityId>>;
+    } &&
+    concepts::ContainerVoidMapFunction<World, Function, T, Args...>
+  /**
+   * Same as the above overload of mapExpired, but used for functions
+   * with a void result type.
+   */
+  inline void mapExpired(const World& w, const Time& now, Function f) {
+    for(const auto id : w.template store<T>().expired(now)) {
+      if(w.template hasAllComponents<Args...>(id)) {
+        f(w.template getUnsafe<T>(id), w.template getUnsafe<Args>(id)...);
+      }
+    }
+  }
+}
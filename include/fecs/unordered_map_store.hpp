@@ -4,12 +4,16 @@
 #include <unordered_map>
 #include <optional>
 #include <concepts>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 
 namespace fecs {
-  template<typename T>
+  template<typename T, typename Allocator = std::allocator<T>>
   /**
    * A store that uses an unordered_map.
    * This saves memory in the case that this component is used infrequently.
+   * Allocator is rebound to allocate the map's nodes.
    *
    * Note: std::unorderd_map has not-so-good performance.
    * In the future I might change this so it also takes a map type
@@ -18,9 +22,25 @@ namespace fecs {
   class unordered_map_store {
 
     using ElementType = T;
-    std::unordered_map<EntityId, ElementType> map;
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<
+      std::pair<const EntityId, ElementType>
+    >;
+    std::unordered_map<
+      EntityId,
+      ElementType,
+      std::hash<EntityId>,
+      std::equal_to<EntityId>,
+      NodeAllocator
+    > map;
 
     public:
+      using ComponentType = T;
+      using allocator_type = Allocator;
+
+      unordered_map_store() = default;
+
+      explicit unordered_map_store(const Allocator& alloc) : map(NodeAllocator(alloc)) {}
+
       template<std::same_as<T> T2 = T>
       inline bool hasComponent(EntityId id) const;
 
@@ -41,47 +61,96 @@ namespace fecs {
 
       // Does not do resizing
       inline void resizeToFit(EntityId id) {}
+
+      /**
+       * An estimate: the map's nodes are not visible to us, so each is counted as
+       * a next pointer plus the key/value pair, and each bucket as one pointer.
+       */
+      inline memory_usage memoryUsage() const {
+        constexpr auto nodeBytes = sizeof(void *) + sizeof(typename decltype(map)::value_type);
+        return {
+          .allocatedBytes = map.size() * nodeBytes + map.bucket_count() * sizeof(void *),
+          .liveBytes = map.size() * sizeof(T),
+          .slots = map.size(),
+          .occupiedSlots = map.size(),
+        };
+      }
+
+      /**
+       * Call f with the id of every entity whose component differs from the one in other,
+       * including entities that only have a component in one of the two stores.
+       */
+      template<std::invocable<EntityId> F>
+      inline void forEachDifference(const unordered_map_store& other, F f) const;
+
+      bool operator==(const unordered_map_store&) const = default;
   };
 
-  template<typename T>
+  template<typename T, typename Allocator>
+  template<std::invocable<EntityId> F>
+  inline void unordered_map_store<T, Allocator>::forEachDifference(
+      const unordered_map_store& other,
+      F f
+  ) const {
+    for(const auto& [id, value] : map) {
+      const auto it = other.map.find(id);
+      if(it == other.map.end() || !(it->second == value)) {
+        f(id);
+      }
+    }
+    for(const auto& [id, value] : other.map) {
+      if(!map.contains(id)) {
+        f(id);
+      }
+    }
+  }
+
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline bool unordered_map_store<T>::hasComponent(EntityId id) const {
+  inline bool unordered_map_store<T, Allocator>::hasComponent(EntityId id) const {
     return map.contains(id);
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline std::optional<T> unordered_map_store<T>::getSafe(EntityId id) const {
+  inline std::optional<T> unordered_map_store<T, Allocator>::getSafe(EntityId id) const {
     auto it = map.find(id);
     if(it != map.end()) {
-      return *it;
+      return it->second;
     }
     return std::nullopt;
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline T unordered_map_store<T>::getUnsafe(EntityId id) const {
+  inline T unordered_map_store<T, Allocator>::getUnsafe(EntityId id) const {
     return map.at(id);
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void unordered_map_store<T>::addComponent(EntityId id, T2 comp) {
-    map.emplace(id, comp);
+  inline void unordered_map_store<T, Allocator>::addComponent(EntityId id, T2 comp) {
+    map.insert_or_assign(id, std::move(comp));
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void unordered_map_store<T>::moveComponent(EntityId id, T2&& t2) {
-    map.emplace(id, std::move(t2));
+  inline void unordered_map_store<T, Allocator>::moveComponent(EntityId id, T2&& t2) {
+    map.insert_or_assign(id, std::move(t2));
   }
 
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void unordered_map_store<T>::removeComponent(EntityId id) {
+  inline void unordered_map_store<T, Allocator>::removeComponent(EntityId id) {
     map.erase(id);
   }
 
+  namespace pmr {
+    /**
+     * An unordered_map_store that allocates from a std::pmr::memory_resource.
+     */
+    template<typename T>
+    using unordered_map_store = fecs::unordered_map_store<T, std::pmr::polymorphic_allocator<T>>;
+  }
 }
@@ -3,20 +3,63 @@
 #include <vector>
 #include <optional>
 #include <concepts>
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
 
 namespace fecs {
 
-  template<typename T>
+  namespace detail {
+    /**
+     * The sequence of std::optional<T> slots a vector_store keeps.
+     * Allocation policies that need more than an allocator can specialize this
+     * (see fecs/huge_page_vector.hpp).
+     */
+    template<typename T, typename Allocator>
+    struct vector_store_storage {
+      using type = std::vector<
+        std::optional<T>,
+        typename std::allocator_traits<Allocator>::template rebind_alloc<std::optional<T>>
+      >;
+    };
+  }
+
+  template<typename T, typename Allocator = std::allocator<T>>
   /**
    * A store backed by a vector of optional values.
    * This makes it very fast (iterating through it generally optimizes out to incrementing a pointer) but it uses a lot of memory.
+   *
+   * Allocator is rebound to allocate the std::optional<T> slots.
+   *
+   * Next to the slots it keeps one presence bit per id, updated on every add and remove,
+   * so parallel mappings can see where matching entities are a word at a time (see presenceWord).
    */
   class vector_store {
 
     using ElementType = T;
-    std::vector<std::optional<ElementType>> elements;
+    using Storage = typename detail::vector_store_storage<T, Allocator>::type;
+    using Words = std::vector<
+      std::uint64_t,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint64_t>
+    >;
+    Storage elements;
+    Words presence;
 
   public:
+    using ComponentType = T;
+    using allocator_type = Allocator;
+
+    vector_store() = default;
+
+    explicit vector_store(const Allocator& alloc)
+      : elements(typename Storage::allocator_type(alloc)),
+        presence(typename Words::allocator_type(alloc)) {}
+
     template<std::same_as<T> T2 = T>
     inline bool hasComponent(EntityId id) const;
 
@@ -37,14 +80,115 @@ namespace fecs {
 
     inline void resizeToFit(EntityId id) {
       elements.resize(std::max(elements.size(), id + 1));
+      presence.resize((elements.size() + 63) / 64);
     }
 
-    auto operator<=>(const vector_store&) const = default;
+    /**
+     * Bit b is set if entity 64 * word + b has a component.
+     */
+    template<std::same_as<T> T2 = T>
+    inline std::uint64_t presenceWord(std::size_t word) const {
+      return word < presence.size() ? presence[word] : 0;
+    }
+
+    /**
+     * Every slot costs a whole std::optional<T>, whether it is occupied or not.
+     */
+    inline memory_usage memoryUsage() const;
+
+    /**
+     * Call f with the id of every slot whose value differs from the same slot in other, until f returns false.
+     * Missing slots past the end of either store count as empty.
+     * Returns false if f stopped the walk.
+     *
+     * For trivially copyable components this compares whole chunks with memcmp first,
+     * and only walks the elements of chunks that are not bitwise identical.
+     */
+    template<std::invocable<EntityId> F>
+    inline bool forEachDifference(const vector_store& other, F f) const;
+
+    /**
+     * Stores are equal if every slot holds the same value.
+     * Unlike a plain vector comparison, trailing empty slots do not matter.
+     */
+    inline bool operator==(const vector_store& other) const;
+
+    /**
+     * Orders stores slot by slot, ignoring trailing empty slots like == does.
+     */
+    inline auto operator<=>(const vector_store& other) const
+      requires std::three_way_comparable<T> {
+      const auto mine = elements.begin();
+      const auto theirs = other.elements.begin();
+      return std::lexicographical_compare_three_way(
+        mine, mine + usedSlots(), theirs, theirs + other.usedSlots()
+      );
+    }
+
+  private:
+    static constexpr std::size_t chunkSize =
+      std::max<std::size_t>(1, 4096 / sizeof(std::optional<ElementType>));
+
+    // The number of slots up to and including the last occupied one.
+    inline std::size_t usedSlots() const {
+      for(auto word = presence.size(); word > 0; --word) {
+        if(presence[word - 1] != 0) {
+          return 64 * word - static_cast<std::size_t>(std::countl_zero(presence[word - 1]));
+        }
+      }
+      return 0;
+    }
   };
 
-  template<typename T>
+  template<typename T, typename Allocator>
+  template<std::invocable<EntityId> F>
+  inline bool vector_store<T, Allocator>::forEachDifference(const vector_store& other, F f) const {
+    const auto common = std::min(elements.size(), other.elements.size());
+    EntityId start = 0;
+    if constexpr(std::is_trivially_copyable_v<std::optional<T>>) {
+      for(; start + chunkSize <= common; start += chunkSize) {
+        const auto same = std::memcmp(
+            elements.data() + start,
+            other.elements.data() + start,
+            chunkSize * sizeof(std::optional<T>)
+        ) == 0;
+        if(same) {
+          continue;
+        }
+        for(EntityId i = start; i < start + chunkSize; ++i) {
+          if(elements[i] != other.elements[i] && !detail::visitDifference(f, i)) {
+            return false;
+          }
+        }
+      }
+    }
+    return detail::forEachSlotDifference(elements, other.elements, f, start);
+  }
+
+  template<typename T, typename Allocator>
+  inline bool vector_store<T, Allocator>::operator==(const vector_store& other) const {
+    return detail::noDifferences(*this, other);
+  }
+
+  template<typename T, typename Allocator>
+  inline memory_usage vector_store<T, Allocator>::memoryUsage() const {
+    std::size_t occupied = 0;
+    for(const auto word : presence) {
+      occupied += static_cast<std::size_t>(std::popcount(word));
+    }
+    return {
+      .allocatedBytes =
+        elements.capacity() * sizeof(std::optional<T>) +
+        presence.capacity() * sizeof(std::uint64_t),
+      .liveBytes = occupied * sizeof(T),
+      .slots = elements.size(),
+      .occupiedSlots = occupied,
+    };
+  }
+
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline bool vector_store<T>::hasComponent(EntityId id) const {
+  inline bool vector_store<T, Allocator>::hasComponent(EntityId id) const {
     if(id >= elements.size()) {
       return false;
     }
@@ -52,47 +196,58 @@ namespace fecs {
     return elements[id].has_value();
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline std::optional<T> vector_store<T>::getSafe(EntityId id) const {
+  inline std::optional<T> vector_store<T, Allocator>::getSafe(EntityId id) const {
     if(id >= elements.size()) {
       return std::nullopt;
     }
     return elements[id];
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline T vector_store<T>::getUnsafe(EntityId id) const {
+  inline T vector_store<T, Allocator>::getUnsafe(EntityId id) const {
     return *(elements.at(id));
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void vector_store<T>::addComponent(EntityId id, T2 comp) {
+  inline void vector_store<T, Allocator>::addComponent(EntityId id, T2 comp) {
     if(elements.size() <= id) {
-      elements.resize(id + 1);
+      resizeToFit(id);
     }
     elements.at(id) = std::move(comp);
+    presence[id / 64] |= std::uint64_t{1} << (id % 64);
   }
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void vector_store<T>::moveComponent(EntityId id, T2&& t2) {
+  inline void vector_store<T, Allocator>::moveComponent(EntityId id, T2&& t2) {
     if(elements.size() <= id) {
-      elements.resize(id + 1);
+      resizeToFit(id);
     }
-    elements.emplace(elements.begin() + id, std::forward<T2&&>(t2));
+    elements[id].emplace(std::forward<T2&&>(t2));
+    presence[id / 64] |= std::uint64_t{1} << (id % 64);
   }
 
 
-  template<typename T>
+  template<typename T, typename Allocator>
   template<std::same_as<T> T2>
-  inline void vector_store<T>::removeComponent(EntityId id) {
+  inline void vector_store<T, Allocator>::removeComponent(EntityId id) {
     if(elements.size() <= id) {
       return;
     }
     elements.at(id) = std::nullopt;
+    presence[id / 64] &= ~(std::uint64_t{1} << (id % 64));
   }
 
+
+  namespace pmr {
+    /**
+     * A vector_store that allocates from a std::pmr::memory_resource.
+     */
+    template<typename T>
+    using vector_store = fecs::vector_store<T, std::pmr::polymorphic_allocator<T>>;
+  }
 }
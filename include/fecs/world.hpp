@@ -2,12 +2,98 @@
 #include <iostream>
 #include <concepts>
 #include "fecs/concepts.hpp"
+#include "fecs/hash.hpp"
+#ifdef FECS_ENABLE_PROFILING
+#include "fecs/profile.hpp"
+#endif
 #include <functional>
 #include <tuple>
 #include <variant>
 #include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <array>
+#include <string>
+#include <ostream>
+#include <memory_resource>
+#include <memory>
+#include <cstdlib>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
 
 namespace fecs {
+  template<typename World>
+  class world_delta;
+
+  namespace detail {
+    template<typename Component, typename ...Stores>
+    struct store_for {};
+
+    template<typename Component, typename Store, typename ...Rest>
+    struct store_for<Component, Store, Rest...> :
+      std::conditional_t<
+        std::same_as<typename Store::ComponentType, Component>,
+        std::type_identity<Store>,
+        store_for<Component, Rest...>
+      > {};
+
+    /**
+     * The first store in a list that holds components of type Component.
+     * If none does there's no `type`, so asking for it is a substitution failure rather than a hard error.
+     */
+    template<typename Component, typename ...Stores>
+    using store_for_t = typename store_for<Component, Stores...>::type;
+
+    /**
+     * T's name as the compiler spells it, demangled where the ABI lets us.
+     */
+    template<typename T>
+    inline std::string typeName() {
+#if defined(__GNUG__)
+      int status = 0;
+      const std::unique_ptr<char, void(*)(void*)> demangled{
+        abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status),
+        std::free
+      };
+      if(status == 0 && demangled) {
+        return demangled.get();
+      }
+#endif
+      return typeid(T).name();
+    }
+
+    /**
+     * What to call a store in reports: its own name() if it has one, otherwise its type.
+     */
+    template<typename Store>
+    inline std::string storeName(const Store& store) {
+      if constexpr(requires { { store.name() } -> std::convertible_to<std::string>; }) {
+        return std::string(store.name());
+      } else {
+        return typeName<Store>();
+      }
+    }
+  }
+
+  /**
+   * Ask for this like a component to get the id of the entity being mapped:
+   *
+   * ```cpp
+   * fecs::mapEntities<fecs::entity, Position>(w, [](fecs::entity e, Position p) -> void { ... });
+   * ```
+   *
+   * Every entity "has" one, and it's made from the loop index, so it costs nothing and needs no store.
+   */
+  struct entity {
+    EntityId id;
+
+    inline operator EntityId() const { return id; }
+
+    bool operator==(const entity&) const = default;
+  };
+
   template<typename ...Stores>
   /**
    * A world in fecs contains multiple components, and entities.
@@ -18,7 +104,18 @@ namespace fecs {
   class world : private Stores... {
     EntityId lastId = 0;
 
+    friend class world_delta<world>;
+
   public:
+    world() = default;
+
+    /**
+     * Make every store allocate from the same memory resource, such as a per-world arena.
+     * This only works when every store takes a std::pmr allocator (see the fecs::pmr stores).
+     */
+    explicit world(std::pmr::memory_resource *resource)
+      requires (std::constructible_from<Stores, std::pmr::memory_resource *> && ...)
+      : Stores(resource)... {}
 
     /**
      * Get a new entity you can do stuff with.
@@ -37,8 +134,60 @@ namespace fecs {
      * TODO: make this something you can iterate via ranges?
      */
     inline EntityId maxId() const { return lastId + 1; }
+
+    /**
+     * A hash of the entire world state, for determinism checks between peers.
+     * This is O(number of stores): every store keeps its own hash up to date as components change
+     * (see fecs::hashed_store).
+     */
+    inline std::uint64_t stateHash() const
+      requires (concepts::StateHashContainer<Stores> && ...) {
+      std::uint64_t hash = detail::mixHash(lastId);
+      ((hash = detail::mixHash(hash ^ Stores::stateHash())), ...);
+      return hash;
+    }
     auto operator<=>(const world&) const = default;
 
+    /**
+     * Memory used by each store, in the same order as the world's store list.
+     */
+    inline std::array<memory_usage, sizeof...(Stores)> memoryUsage() const
+      requires (concepts::MemoryUsageContainer<Stores> && ...) {
+      return { Stores::memoryUsage()... };
+    }
+
+    /**
+     * Write a human-readable table of memoryUsage(), with a total at the end.
+     * Each line is labelled with the store's name() if it has one, otherwise with its type.
+     */
+    inline void writeMemoryReport(std::ostream& out) const
+      requires (concepts::MemoryUsageContainer<Stores> && ...);
+
+    /**
+     * Get the store that holds components of type Component.
+     * This gives access to store-specific functionality the world itself does not forward.
+     */
+    template<typename Component>
+    inline const detail::store_for_t<Component, Stores...>& store() const {
+      return static_cast<const detail::store_for_t<Component, Stores...>&>(*this);
+    }
+
+    template<typename Component>
+    inline detail::store_for_t<Component, Stores...>& store() {
+      return static_cast<detail::store_for_t<Component, Stores...>&>(*this);
+    }
+
+    /**
+     * Bitmask of which of the ids 64 * word to 64 * word + 63 have *all* of Elements,
+     * for stores that can answer that a word at a time (like fecs::tag_store or fecs::vector_store).
+     */
+    template<typename ...Elements>
+      requires (sizeof...(Elements) > 0) &&
+        (concepts::PresenceMaskContainer<detail::store_for_t<Elements, Stores...>, Elements> && ...)
+    inline std::uint64_t presenceWord(std::size_t word) const {
+      return (store<Elements>().template presenceWord<Elements>(word) & ...);
+    }
+
     using Stores::hasComponent...;
     using Stores::getSafe...;
     using Stores::getUnsafe...;
@@ -70,6 +219,16 @@ namespace fecs {
       return this->template getSafe<F>(id);
     }
 
+    template<std::same_as<entity> T>
+    inline bool hasComponent(EntityId) const {
+      return true;
+    }
+
+    template<std::same_as<entity> T>
+    inline entity getUnsafe(EntityId id) const {
+      return entity{id};
+    }
+
     template<typename ...Elements>
       requires (concepts::QueryContainer<world, Elements> && ...)
     /**
@@ -143,6 +302,15 @@ namespace fecs {
 
   private:
 
+    static inline void writeMemoryLine(std::ostream& out, const char *name, const memory_usage& usage) {
+      out << name
+          << ": allocated " << usage.allocatedBytes
+          << " B, live " << usage.liveBytes
+          << " B, overhead " << usage.overheadBytes()
+          << " B, slots " << usage.occupiedSlots << "/" << usage.slots
+          << " (" << usage.occupancy() * 100.0 << "% occupied)\n";
+    }
+
     template<typename Tuple, std::size_t ...Indexes>
     inline void setMapResultTupleDetail(
         EntityId id,
@@ -168,6 +336,101 @@ namespace fecs {
     }
   };
 
+  template<typename ...Stores>
+  inline void world<Stores...>::writeMemoryReport(std::ostream& out) const
+    requires (concepts::MemoryUsageContainer<Stores> && ...) {
+    const std::array<std::string, sizeof...(Stores)> names{
+      detail::storeName(static_cast<const Stores&>(*this))...
+    };
+    const auto usages = memoryUsage();
+    memory_usage total;
+    for(std::size_t i = 0; i < usages.size(); ++i) {
+      writeMemoryLine(out, names[i].c_str(), usages[i]);
+      total += usages[i];
+    }
+    writeMemoryLine(out, "total", total);
+  }
+
+  namespace detail {
+    /**
+     * Make a slot hold exactly `value`, as read back by getSafe.
+     * Unlike setMapResult with an optional, this also works for stores that can't remove,
+     * as long as nothing actually needs removing.
+     */
+    template<typename Component, typename World>
+    inline void assignSlot(World& w, EntityId id, const std::optional<Component>& value) {
+      if(value) {
+        w.template addComponent<Component>(id, *value);
+      }
+      else if constexpr(concepts::RemoveContainer<World, Component>) {
+        w.template removeComponent<Component>(id);
+      }
+    }
+
+    /**
+     * Stand-in for fecs::map_stats when nothing is being measured.
+     * Every call inlines away, so the plain mapping loop is unaffected.
+     */
+    struct no_stats {
+      inline void visit() {}
+      inline void match() {}
+      inline void write(std::uint64_t) {}
+    };
+
+    // How many components a mapper result adds or replaces, for fecs::map_stats::written.
+    template<typename Result>
+    inline std::uint64_t componentsWritten(const Result&) { return 1; }
+
+    template<typename Result>
+    inline std::uint64_t componentsWritten(const std::optional<Result>& result) {
+      return result.has_value() ? 1 : 0;
+    }
+
+    template<typename ...Results>
+    inline std::uint64_t componentsWritten(const std::tuple<Results...>& results) {
+      return std::apply([](const auto& ...r) { return (componentsWritten(r) + ... + 0); }, results);
+    }
+
+    template<typename ...Results>
+    inline std::uint64_t componentsWritten(const std::variant<Results...>& result) {
+      return std::visit([](const auto& r) { return componentsWritten(r); }, result);
+    }
+
+    template<
+      typename ...Args,
+      typename Function,
+      typename World,
+      typename Stats
+    >
+    inline void mapEntitiesLoop(World& w, Function& f, Stats& stats) {
+      for(EntityId i = 0; i < w.maxId(); ++i) {
+        stats.visit();
+        if((w.template hasAllComponents<Args...>(i))) {
+          stats.match();
+          const auto result = f(w.template getUnsafe<Args>(i)...);
+          stats.write(componentsWritten(result));
+          w.template setMapResult<std::remove_cvref_t<decltype(result)>>(i, result);
+        }
+      }
+    }
+
+    template<
+      typename ...Args,
+      typename Function,
+      typename World,
+      typename Stats
+    >
+    inline void mapEntitiesVoidLoop(const World& w, Function& f, Stats& stats) {
+      for(EntityId i = 0; i < w.maxId(); ++i) {
+        stats.visit();
+        if((w.template hasAllComponents<Args...>(i))) {
+          stats.match();
+          f(w.template getUnsafe<Args>(i)...);
+        }
+      }
+    }
+  }
+
   /**
    * Apply a mapper function over each applicable entity.
    * For each Entity that has all components in Args, call the function,
@@ -185,12 +448,8 @@ namespace fecs {
   > requires 
       concepts::ContainerMapFunction<World, Function, Args...>
   inline void mapEntities(World& w, Function f) {
-    for(EntityId i = 0; i < w.maxId(); ++i) {
-      if((w.template hasAllComponents<Args...>(i))) {
-        w.template setMapResult<decltype(f(w.template getUnsafe<Args>(i)...))>
-          (i, f(w.template getUnsafe<Args>(i)...));
-      }
-    }
+    detail::no_stats stats;
+    detail::mapEntitiesLoop<Args...>(w, f, stats);
   }
 
   /**
@@ -203,10 +462,40 @@ namespace fecs {
     typename World
   > requires concepts::ContainerVoidMapFunction<World, Function, Args...>
   inline void mapEntities(const World& w, Function f) {
-    for(EntityId i = 0; i < w.maxId(); ++i) {
-      if((w.template hasAllComponents<Args...>(i))) {
-        f(w.template getUnsafe<Args>(i)...);
-      }
-    }
+    detail::no_stats stats;
+    detail::mapEntitiesVoidLoop<Args...>(w, f, stats);
+  }
+
+  /**
+   * Same as the unnamed mapEntities, but if the build defines FECS_ENABLE_PROFILING,
+   * the call is timed and counted under `name` in fecs::profiler (see fecs/profile.hpp).
+   */
+  template<
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires 
+      concepts::ContainerMapFunction<World, Function, Args...>
+  inline void mapEntities(World& w, const char *name, Function f) {
+#ifdef FECS_ENABLE_PROFILING
+    detail::profile_scope scope{name};
+    detail::mapEntitiesLoop<Args...>(w, f, scope.stats);
+#else
+    mapEntities<Args...>(w, std::move(f));
+#endif
+  }
+
+  template<
+    typename ...Args,
+    typename Function,
+    typename World
+  > requires concepts::ContainerVoidMapFunction<World, Function, Args...>
+  inline void mapEntities(const World& w, const char *name, Function f) {
+#ifdef FECS_ENABLE_PROFILING
+    detail::profile_scope scope{name};
+    detail::mapEntitiesVoidLoop<Args...>(w, f, scope.stats);
+#else
+    mapEntities<Args...>(w, std::move(f));
+#endif
   }
 }
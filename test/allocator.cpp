@@ -0,0 +1,61 @@
+#include "fecs/world.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "catch.hpp"
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+using namespace fecs;
+
+using PmrWorld = world<pmr::vector_store<int>, pmr::unordered_map_store<float>>;
+
+static_assert(std::constructible_from<PmrWorld, std::pmr::memory_resource *>);
+static_assert(!std::constructible_from<world<vector_store<int>>, std::pmr::memory_resource *>);
+
+namespace {
+  // Counts allocations so we can see the stores really use the resource we gave them.
+  class counting_resource : public std::pmr::memory_resource {
+  public:
+    std::size_t allocations = 0;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  };
+}
+
+TEST_CASE("every store allocates from the world's memory resource") {
+  counting_resource resource;
+  PmrWorld w{&resource};
+
+  for(int i = 0; i < 100; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    w.addComponent(e, static_cast<float>(i));
+  }
+
+  REQUIRE(resource.allocations > 100);
+  REQUIRE(w.getSafe<int>(42) == 42);
+  REQUIRE(w.getSafe<float>(42) == 42.0f);
+}
+
+TEST_CASE("stores work with a monotonic arena") {
+  std::array<std::byte, 1 << 16> buffer;
+  std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+  pmr::vector_store<int> store{&arena};
+
+  store.addComponent(10, 1);
+  REQUIRE(store.getUnsafe(10) == 1);
+  REQUIRE(store.hasComponent(9) == false);
+}
@@ -0,0 +1,119 @@
+#include "fecs/delta.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "fecs/tag_store.hpp"
+#include "catch.hpp"
+#include <sstream>
+
+using namespace fecs;
+
+using DeltaWorld =
+  world<vector_store<int>, unordered_map_store<float>>;
+
+static DeltaWorld makeDeltaWorld() {
+  DeltaWorld w;
+  for(int i = 0; i < 10; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 2 == 0) {
+      w.addComponent(e, static_cast<float>(i));
+    }
+  }
+  return w;
+}
+
+TEST_CASE("deltas between identical worlds are empty") {
+  const auto w = makeDeltaWorld();
+
+  REQUIRE(world_delta<DeltaWorld>::between(w, w).empty());
+}
+
+TEST_CASE("deltas only record changed slots") {
+  const auto before = makeDeltaWorld();
+  auto after = before;
+
+  after.addComponent(3, 30);
+  after.removeComponent<float>(4);
+  const auto e = after.newEntity();
+  after.addComponent(e, 1.5f);
+
+  const auto delta = world_delta<DeltaWorld>::between(before, after);
+  REQUIRE(delta.size() == 3);
+
+  SECTION("applying turns the old world into the new one") {
+    auto applied = before;
+    delta.applyTo(applied);
+    REQUIRE(applied.maxId() == after.maxId());
+    REQUIRE(applied.getSafe<int>(3) == 30);
+    REQUIRE(applied.getSafe<float>(4) == std::nullopt);
+    REQUIRE(applied.getSafe<float>(e) == 1.5f);
+    REQUIRE(world_delta<DeltaWorld>::between(applied, after).empty());
+  }
+
+  SECTION("deltas survive serialization") {
+    std::stringstream stream;
+    delta.write(stream);
+    REQUIRE(world_delta<DeltaWorld>::read(stream) == delta);
+  }
+
+  SECTION("reading a truncated delta throws") {
+    std::stringstream stream;
+    delta.write(stream);
+    auto bytes = stream.str();
+    bytes.pop_back();
+    std::stringstream truncated{bytes};
+    REQUIRE_THROWS_AS(world_delta<DeltaWorld>::read(truncated), std::runtime_error);
+  }
+}
+
+TEST_CASE("applying a delta to a larger world shrinks it") {
+  const auto before = makeDeltaWorld();
+  auto after = before;
+  const auto e = after.newEntity();
+  after.addComponent(e, 99);
+
+  world_delta<DeltaWorld>::between(after, before).applyTo(after);
+  REQUIRE(after.maxId() == before.maxId());
+  REQUIRE(after.hasComponent<int>(e) == false);
+}
+
+namespace {
+  // Tags usually don't bother defining ==.
+  struct Frozen {};
+
+  struct Armor {
+    explicit Armor(int points) : points(points) {}
+    int points;
+
+    bool operator==(const Armor&) const = default;
+  };
+}
+
+TEST_CASE("deltas work with tags without == and components without default constructors") {
+  using TaggedWorld = world<vector_store<Armor>, tag_store<Frozen>>;
+  TaggedWorld before;
+  for(int i = 0; i < 4; ++i) {
+    const auto e = before.newEntity();
+    before.addComponent(e, Armor{i});
+  }
+  before.addComponent(1, Frozen{});
+
+  auto after = before;
+  after.addComponent(2, Armor{10});
+  after.removeComponent<Frozen>(1);
+  after.addComponent(3, Frozen{});
+
+  const auto delta = world_delta<TaggedWorld>::between(before, after);
+  REQUIRE(delta.size() == 3);
+
+  std::stringstream stream;
+  delta.write(stream);
+  const auto read = world_delta<TaggedWorld>::read(stream);
+
+  auto applied = before;
+  read.applyTo(applied);
+  REQUIRE(applied.getSafe<Armor>(2) == Armor{10});
+  REQUIRE(applied.hasComponent<Frozen>(1) == false);
+  REQUIRE(applied.hasComponent<Frozen>(3));
+  REQUIRE(world_delta<TaggedWorld>::between(applied, after).empty());
+}
@@ -0,0 +1,62 @@
+#include "fecs/diff.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+using DiffWorld =
+  world<vector_store<int>, unordered_map_store<float>>;
+
+static_assert(concepts::DiffContainer<vector_store<int>>);
+static_assert(concepts::DiffContainer<unordered_map_store<float>>);
+static_assert(component_index_v<DiffWorld, int> == 0);
+static_assert(component_index_v<DiffWorld, float> == 1);
+
+static DiffWorld makeDiffWorld() {
+  DiffWorld w;
+  for(int i = 0; i < 5000; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 3 == 0) {
+      w.addComponent(e, static_cast<float>(i));
+    }
+  }
+  return w;
+}
+
+TEST_CASE("identical worlds have no differences") {
+  const auto a = makeDiffWorld();
+  const auto b = a;
+
+  REQUIRE(diff(a, b).empty());
+  REQUIRE(a == b);
+}
+
+TEST_CASE("diff reports each changed slot") {
+  const auto a = makeDiffWorld();
+  auto b = a;
+
+  b.addComponent(4000, -1);
+  b.removeComponent<float>(3);
+  b.addComponent(1, 2.0f);
+
+  REQUIRE(diff(a, b) == std::vector<difference>{
+    {1, component_index_v<DiffWorld, float>},
+    {3, component_index_v<DiffWorld, float>},
+    {4000, component_index_v<DiffWorld, int>},
+  });
+  REQUIRE(diff(a, b) == diff(b, a));
+  REQUIRE_FALSE(a == b);
+}
+
+TEST_CASE("diff ignores bytes left behind by removed components") {
+  auto a = makeDiffWorld();
+  auto b = a;
+
+  a.removeComponent<int>(10);
+  b.addComponent(10, 1234);
+  b.removeComponent<int>(10);
+
+  REQUIRE(diff(a, b).empty());
+}
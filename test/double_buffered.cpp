@@ -0,0 +1,56 @@
+#include "fecs/double_buffered.hpp"
+#include "fecs/vector_store.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+using BufferedWorld = world<vector_store<int>, vector_store<float>>;
+
+static_assert(concepts::MapResultContainer<int, double_buffered<BufferedWorld>>);
+static_assert(
+    concepts::MapResultContainer<std::variant<std::optional<int>, float>, double_buffered<BufferedWorld>>
+);
+
+TEST_CASE("double-buffered mapping") {
+  double_buffered<BufferedWorld> w;
+  for(int i = 0; i < 10; ++i) {
+    w.addComponent(w.newEntity(), i);
+  }
+
+  SECTION("writes are invisible until swap") {
+    REQUIRE(w.hasComponent<int>(0) == false);
+    w.swap();
+    REQUIRE(w.getSafe<int>(3) == 3);
+  }
+
+  w.swap();
+
+  SECTION("systems only see the previous frame") {
+    mapEntities<int>(w, [](int i) -> int { return i + 1; });
+    mapEntities<int>(w, [](int i) -> float { return static_cast<float>(i); });
+
+    REQUIRE(w.getSafe<int>(3) == 3);
+    REQUIRE(w.hasComponent<float>(3) == false);
+
+    w.swap();
+    REQUIRE(w.getSafe<int>(3) == 4);
+    REQUIRE(w.getSafe<float>(3) == 3.0f);
+
+    SECTION("the back buffer catches up after swapping") {
+      mapEntities<int>(w, [](int i) -> std::optional<int> {
+        if(i == 4) {
+          return std::nullopt;
+        }
+        return i;
+      });
+      w.swap();
+      REQUIRE(w.hasComponent<int>(3) == false);
+      REQUIRE(w.getSafe<float>(3) == 3.0f);
+      REQUIRE(w.getSafe<int>(4) == 5);
+
+      w.swap();
+      REQUIRE(w.current().hasComponent<int>(3) == false);
+      REQUIRE(w.getSafe<int>(4) == 5);
+    }
+  }
+}
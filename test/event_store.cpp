@@ -0,0 +1,66 @@
+#include "fecs/event_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+namespace {
+  struct Damage {
+    int amount;
+
+    bool operator==(const Damage&) const = default;
+  };
+}
+
+using EventWorld = world<vector_store<int>, event_store<Damage>>;
+
+static_assert(concepts::AddContainer<EventWorld, Damage>);
+static_assert(!concepts::RemoveContainer<EventWorld, Damage>);
+static_assert(!concepts::QueryContainer<EventWorld, Damage>);
+static_assert(concepts::MapResultContainer<Damage, EventWorld>);
+static_assert(!concepts::MapResultContainer<std::optional<Damage>, EventWorld>);
+
+TEST_CASE("event stores append and clear") {
+  event_store<Damage> store;
+  store.addComponent(3, Damage{1});
+  store.addComponent(1, Damage{2});
+  store.addComponent(3, Damage{3});
+  REQUIRE(store.size() == 3);
+  REQUIRE(store.all()[0].entity == 3);
+  REQUIRE(store.all()[2].value == Damage{3});
+  REQUIRE(store.memoryUsage().occupiedSlots == 3);
+
+  store.clear();
+  REQUIRE(store.empty());
+  REQUIRE(store.memoryUsage().slots >= 3);
+}
+
+TEST_CASE("mappers raise and consume events") {
+  EventWorld w;
+  for(int i = 0; i < 10; ++i) {
+    w.addComponent(w.newEntity(), 100);
+  }
+
+  // Everyone hurts themselves twice.
+  mapEntities<int>(w, [](int health) { return Damage{health / 50}; });
+  mapEntities<int>(w, [](int health) { return Damage{health / 50}; });
+  REQUIRE(w.store<Damage>().size() == 20);
+
+  mapEvents<Damage, int>(w, [](const Damage& d, int health) { return health - d.amount; });
+  for(EntityId i = 0; i < 10; ++i) {
+    REQUIRE(w.getUnsafe<int>(i) == 96);
+  }
+
+  int total = 0;
+  mapEvents<Damage>(w, [&](const Damage& d) { total += d.amount; });
+  REQUIRE(total == 40);
+
+  SECTION("events raised while consuming wait for the next pass") {
+    mapEvents<Damage>(w, [](const Damage& d) { return Damage{d.amount}; });
+    REQUIRE(w.store<Damage>().size() == 40);
+  }
+
+  w.store<Damage>().clear();
+  REQUIRE(w.store<Damage>().empty());
+}
@@ -0,0 +1,184 @@
+#include "fecs/executor.hpp"
+#include "fecs/reduce.hpp"
+#include "fecs/tag_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "fecs/paged_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace fecs;
+
+namespace {
+  struct Ai {};
+}
+
+using ClusterWorld = world<vector_store<int>, tag_store<Ai>>;
+
+TEST_CASE("work-stealing executors run every task once") {
+  for(std::size_t workers : {1, 3, 8}) {
+    work_stealing_executor executor{workers};
+    std::vector<std::atomic<int>> runs(100);
+    executor.run(runs.size(), [&](std::size_t task) { ++runs[task]; });
+    for(const auto& r : runs) {
+      REQUIRE(r == 1);
+    }
+  }
+
+  SECTION("more workers than tasks") {
+    std::atomic<int> runs = 0;
+    work_stealing_executor{16}.run(2, [&](std::size_t) { ++runs; });
+    REQUIRE(runs == 2);
+  }
+
+  SECTION("exceptions reach the caller after every task ran") {
+    std::atomic<int> runs = 0;
+    auto failing = [&](std::size_t task) {
+      ++runs;
+      if(task % 10 == 3) {
+        throw std::runtime_error("bad task");
+      }
+    };
+    REQUIRE_THROWS_AS(work_stealing_executor{4}.run(50, failing), std::runtime_error);
+    REQUIRE(runs == 50);
+  }
+}
+
+TEST_CASE("chunks follow matched entities") {
+  ClusterWorld w;
+  for(int i = 0; i < 400000; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i >= 200000 && i < 300000) {
+      w.addComponent(e, Ai{});
+    }
+  }
+
+  const auto chunks = detail::planChunks<Ai, int>(w);
+  // One chunk per ~16k matches inside the cluster, and only a couple for the empty ids around it.
+  REQUIRE(chunks.size() < 12);
+  REQUIRE(chunks.front().begin == 0);
+  REQUIRE(chunks.back().end == w.maxId());
+  std::size_t inCluster = 0;
+  for(std::size_t c = 0; c < chunks.size(); ++c) {
+    if(c > 0) {
+      REQUIRE(chunks[c].begin == chunks[c - 1].end);
+    }
+    if(chunks[c].begin >= 200000 && chunks[c].end <= 300000) {
+      ++inCluster;
+      REQUIRE(chunks[c].end - chunks[c].begin < 2 * detail::chunkWork);
+    }
+  }
+  REQUIRE(inCluster >= 4);
+
+
+  SECTION("parallel mapping and reductions only visit matches") {
+    std::atomic<long long> total = 0;
+    mapEntitiesParallel<Ai, int>(w, [&](Ai, int i) { total += i; });
+    const long long expected = 100000LL * (200000 + 299999) / 2;
+    REQUIRE(total == expected);
+    REQUIRE(count<Ai>(w) == 100000);
+    REQUIRE(reduce<int, Ai>(w, 0LL, [](long long acc, int i, Ai) { return acc + i; }, std::plus<>{}) == expected);
+  }
+}
+
+TEST_CASE("parallel mappings with arguments that have no store") {
+  world<vector_store<int>, vector_store<float>> w;
+  for(int i = 0; i < 40000; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 2 == 0) {
+      w.addComponent(e, 1.0f);
+    }
+  }
+
+  const long long ids = reduce<fecs::entity, int>(
+      w,
+      0LL,
+      [](long long acc, fecs::entity e, int i) { return acc + static_cast<long long>(e.id) - i; },
+      std::plus<>{}
+  );
+  REQUIRE(ids == 0);
+
+  const auto floats = reduce<std::optional<float>>(
+      w,
+      0,
+      [](int acc, const std::optional<float>& f) { return acc + (f ? 1 : 0); },
+      std::plus<>{}
+  );
+  REQUIRE(floats == 20000);
+
+  const auto byParity = groupBy<int, fecs::entity, std::optional<float>>(
+      w,
+      0,
+      [](int acc, fecs::entity e, const std::optional<float>& f) { return acc + (f && e.id % 2 == 0 ? 1 : 0); },
+      std::plus<>{}
+  );
+  REQUIRE(byParity.size() == 40000);
+  REQUIRE(byParity.at(2) == 1);
+  REQUIRE(byParity.at(3) == 0);
+
+  std::atomic<long long> total = 0;
+  mapEntitiesParallel<fecs::entity, int>(w, [&](fecs::entity e, int i) {
+    total += static_cast<long long>(e.id) - i + 1;
+  });
+  REQUIRE(total == 40000);
+}
+
+TEST_CASE("chunks follow clusters in ordinary stores") {
+  world<vector_store<int>, paged_store<float>> w;
+  for(int i = 0; i < 400000; ++i) {
+    const auto e = w.newEntity();
+    if(i >= 300000 && i < 350000) {
+      w.addComponent(e, i);
+      w.addComponent(e, 1.0f);
+    }
+  }
+
+  for(const auto& chunks : {detail::planChunks<int>(w), detail::planChunks<float>(w), detail::planChunks<int, float>(w)}) {
+    // ~7k words outside the cluster make one chunk, and the 50k matches about three more.
+    REQUIRE(chunks.size() <= 5);
+    std::size_t inCluster = 0;
+    for(const auto& c : chunks) {
+      if(c.begin >= 300000 && c.end <= 350000) {
+        ++inCluster;
+      }
+    }
+    REQUIRE(inCluster >= 2);
+  }
+  REQUIRE(reduce<int>(w, 0LL, [](long long acc, int i) { return acc + i; }, std::plus<>{}) == 25000LL * 649999);
+  REQUIRE(count<int, float>(w) == 50000);
+
+  SECTION("stores without presence hints get equal id ranges") {
+    world<unordered_map_store<int>> sparse;
+    for(int i = 0; i < 100000; ++i) {
+      sparse.addComponent(sparse.newEntity(), i);
+    }
+    const auto plain = detail::planChunks<int>(sparse);
+    REQUIRE(plain.size() == (sparse.maxId() + detail::chunkWork - 1) / detail::chunkWork);
+  }
+}
+
+TEST_CASE("presence words track adds and removes") {
+  vector_store<int> v;
+  paged_store<int, 128> p;
+  paged_store<int, 100> odd;
+  for(EntityId id : {1, 64, 130, 190}) {
+    v.addComponent(id, 0);
+    p.addComponent(id, 0);
+    odd.addComponent(id, 0);
+  }
+  v.removeComponent(64);
+  p.removeComponent(64);
+  odd.removeComponent(64);
+  for(std::size_t word = 0; word < 4; ++word) {
+    REQUIRE(v.presenceWord(word) == p.presenceWord(word));
+    REQUIRE(v.presenceWord(word) == odd.presenceWord(word));
+  }
+  REQUIRE(v.presenceWord(0) == 2);
+  REQUIRE(v.presenceWord(1) == 0);
+  REQUIRE(v.presenceWord(2) == ((std::uint64_t{1} << 2) | (std::uint64_t{1} << 62)));
+}
@@ -0,0 +1,119 @@
+#include "fecs/hashed_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "fecs/rle_store.hpp"
+#include "fecs/singleton_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+using HashedWorld = world<
+  hashed_store<vector_store<int>>,
+  hashed_store<unordered_map_store<float>>
+>;
+
+static_assert(concepts::StateHashContainer<hashed_store<vector_store<int>>>);
+static_assert(concepts::MapResultContainer<std::optional<int>, HashedWorld>);
+
+TEST_CASE("hashed stores track their contents") {
+  hashed_store<vector_store<int>> store;
+  REQUIRE(store.stateHash() == 0);
+
+  store.addComponent(0, 10);
+  const auto withTen = store.stateHash();
+  REQUIRE(withTen != 0);
+
+  SECTION("replacing a value rehashes the slot") {
+    store.addComponent(0, 11);
+    REQUIRE(store.stateHash() != withTen);
+    store.addComponent(0, 10);
+    REQUIRE(store.stateHash() == withTen);
+  }
+
+  SECTION("removing a value unhashes it") {
+    store.removeComponent(0);
+    REQUIRE(store.stateHash() == 0);
+  }
+
+  SECTION("the same value in another slot hashes differently") {
+    hashed_store<vector_store<int>> other;
+    other.addComponent(1, 10);
+    REQUIRE(other.stateHash() != withTen);
+  }
+}
+
+TEST_CASE("world state hashes follow mapping") {
+  HashedWorld a;
+  HashedWorld b;
+  for(int i = 0; i < 100; ++i) {
+    a.addComponent(a.newEntity(), i);
+  }
+  for(int i = 99; i >= 0; --i) {
+    b.newEntity();
+  }
+  for(int i = 99; i >= 0; --i) {
+    b.addComponent(static_cast<EntityId>(i), i);
+  }
+
+  REQUIRE(a.stateHash() == b.stateHash());
+
+  mapEntities<int>(a, [](int i) -> std::variant<std::optional<int>, float> {
+    if(i % 2 == 0) {
+      return {static_cast<float>(i)};
+    }
+    return {std::optional<int>{std::nullopt}};
+  });
+  REQUIRE(a.stateHash() != b.stateHash());
+
+  mapEntities<int>(b, [](int i) -> std::variant<std::optional<int>, float> {
+    if(i % 2 == 0) {
+      return {static_cast<float>(i)};
+    }
+    return {std::optional<int>{std::nullopt}};
+  });
+  REQUIRE(a.stateHash() == b.stateHash());
+}
+
+TEST_CASE("hashed rle stores rehash bulk writes") {
+  using RunWorld = world<hashed_store<rle_store<int>>>;
+  RunWorld a;
+  RunWorld b;
+  for(int i = 0; i < 100; ++i) {
+    a.addComponent(a.newEntity(), i / 25);
+    b.newEntity();
+  }
+  b.store<int>().setRange(0, 50, 1);
+  b.store<int>().setRange(50, 50, 3);
+
+  mapRuns<int>(a, [](int team) -> std::optional<int> { return team < 2 ? 1 : 3; });
+  REQUIRE(a.store<int>().allRuns() == b.store<int>().allRuns());
+  REQUIRE(a.stateHash() == b.stateHash());
+  REQUIRE(a == b);
+
+  mapRuns<int>(a, [](int team) -> std::optional<int> {
+    if(team == 1) {
+      return std::nullopt;
+    }
+    return team;
+  });
+  b.store<int>().setRange(0, 50, std::nullopt);
+  REQUIRE(a.stateHash() == b.stateHash());
+  REQUIRE(a == b);
+}
+
+TEST_CASE("hashed singletons hash one slot whichever id writes it") {
+  hashed_store<singleton_store<int>> a;
+  hashed_store<singleton_store<int>> b;
+  hashed_store<singleton_store<int>> c{6};
+  REQUIRE(a.stateHash() == b.stateHash());
+
+  a.addComponent(3, 5);
+  a.addComponent(7, 6);
+  b.set(6);
+  REQUIRE(a.stateHash() == b.stateHash());
+  REQUIRE(c.stateHash() == b.stateHash());
+
+  a.addComponent(1, 0);
+  REQUIRE(a.stateHash() == hashed_store<singleton_store<int>>{}.stateHash());
+}
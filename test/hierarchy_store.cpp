@@ -0,0 +1,94 @@
+#include "fecs/hierarchy_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+namespace {
+  struct Local {
+    int offset;
+  };
+
+  struct Global {
+    int position;
+
+    bool operator==(const Global&) const = default;
+  };
+
+  using Node = hierarchy_store::node;
+}
+
+using TreeWorld = world<hierarchy_store, vector_store<Local>, vector_store<Global>>;
+
+static_assert(concepts::MapResultContainer<std::optional<parent>, TreeWorld>);
+static_assert(concepts::DiffContainer<hierarchy_store>);
+
+TEST_CASE("hierarchy stores keep a depth-first order") {
+  hierarchy_store store;
+  //   0        5
+  //  / \       |
+  // 1   3      6
+  // |
+  // 2
+  store.addComponent(3, parent{0});
+  store.addComponent(1, parent{0});
+  store.addComponent(2, parent{1});
+  store.addComponent(6, parent{5});
+
+  REQUIRE(store.depthFirst() == std::vector<Node>{{0, 0}, {1, 1}, {2, 2}, {3, 1}, {5, 0}, {6, 1}});
+
+  SECTION("reparenting rebuilds the order") {
+    store.addComponent(5, parent{3});
+    REQUIRE(store.depthFirst() == std::vector<Node>{{0, 0}, {1, 1}, {2, 2}, {3, 1}, {5, 2}, {6, 3}});
+  }
+
+  SECTION("removing a parent makes a new root") {
+    store.removeComponent(1);
+    REQUIRE(store.depthFirst() == std::vector<Node>{{0, 0}, {3, 1}, {1, 0}, {2, 1}, {5, 0}, {6, 1}});
+  }
+
+  SECTION("cycles are left out") {
+    store.addComponent(5, parent{6});
+    REQUIRE(store.depthFirst() == std::vector<Node>{{0, 0}, {1, 1}, {2, 2}, {3, 1}});
+  }
+
+  SECTION("copies compare by parents") {
+    auto copy = store;
+    REQUIRE(copy == store);
+    copy.addComponent(2, parent{3});
+    REQUIRE(!(copy == store));
+    REQUIRE(copy.depthFirst() != store.depthFirst());
+  }
+}
+
+TEST_CASE("mapping down a hierarchy") {
+  TreeWorld w;
+  for(int i = 0; i < 6; ++i) {
+    w.addComponent(w.newEntity(), Local{i * 10});
+  }
+  // Children come before their parents in id order, so parents must not be read by id.
+  w.addComponent(0, parent{2});
+  w.addComponent(1, parent{0});
+  w.addComponent(3, parent{2});
+  w.addComponent(5, parent{4});
+
+  mapHierarchy<Global, Local>(w, [](const std::optional<Global>& above, const Local& local) {
+    return Global{(above ? above->position : 0) + local.offset};
+  });
+
+  REQUIRE(w.getSafe<Global>(2) == Global{20});
+  REQUIRE(w.getSafe<Global>(0) == Global{20});
+  REQUIRE(w.getSafe<Global>(1) == Global{30});
+  REQUIRE(w.getSafe<Global>(3) == Global{50});
+  REQUIRE(w.getSafe<Global>(5) == Global{90});
+
+  SECTION("entities without the inputs break the chain") {
+    w.removeComponent<Local>(0);
+    w.removeComponent<Global>(1);
+    mapHierarchy<Global, Local>(w, [](const std::optional<Global>& above, const Local& local) {
+      return Global{(above ? above->position : 0) + local.offset};
+    });
+    REQUIRE(w.getSafe<Global>(1) == Global{10});
+  }
+}
@@ -0,0 +1,61 @@
+#include "fecs/history.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/unordered_map_store.hpp"
+#include "catch.hpp"
+#include <vector>
+
+using namespace fecs;
+
+using HistoryWorld =
+  world<vector_store<int>, unordered_map_store<float>>;
+
+static void step(HistoryWorld& w) {
+  const auto e = w.newEntity();
+  w.addComponent(e, 0);
+  mapEntities<int>(w, [](int i) -> std::tuple<int, std::optional<float>> {
+    if(i % 3 == 2) {
+      return { i + 1, std::nullopt };
+    }
+    return { i + 1, static_cast<float>(i) };
+  });
+}
+
+TEST_CASE("history keeps a bounded number of frames") {
+  history<HistoryWorld> h{4};
+  HistoryWorld w;
+  std::vector<HistoryWorld> frames;
+
+  for(int i = 0; i < 10; ++i) {
+    step(w);
+    h.push(w);
+    frames.push_back(w);
+  }
+
+  REQUIRE(h.size() == 4);
+  REQUIRE(h.current() == frames.back());
+
+  SECTION("rewinding restores older frames exactly") {
+    REQUIRE(h.rewind(1) == frames[8]);
+    REQUIRE(h.rewind(2) == frames[6]);
+    REQUIRE(h.size() == 1);
+  }
+
+  SECTION("rewinding past the oldest frame throws") {
+    REQUIRE_THROWS_AS(h.rewind(4), std::out_of_range);
+  }
+
+  SECTION("re-simulating after a rewind continues the history") {
+    auto resim = h.rewind(3);
+    step(resim);
+    h.push(resim);
+    REQUIRE(h.size() == 2);
+    REQUIRE(h.current() == frames[7]);
+    REQUIRE(h.rewind(1) == frames[6]);
+  }
+}
+
+TEST_CASE("an empty history has no current frame") {
+  history<HistoryWorld> h{2};
+  REQUIRE(h.empty());
+  REQUIRE_THROWS_AS(h.current(), std::out_of_range);
+}
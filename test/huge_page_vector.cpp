@@ -0,0 +1,68 @@
+#include "fecs/huge_page_vector.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <vector>
+
+using namespace fecs;
+
+static_assert(concepts::MapResultContainer<std::optional<int>, world<huge_page_store<int>>>);
+static_assert(std::same_as<
+  std::allocator_traits<huge_page_store<int>::allocator_type>::rebind_alloc<char>,
+  huge_page_allocator<char>
+>);
+
+TEST_CASE("huge page allocators work with standard containers") {
+  std::vector<int, huge_page_allocator<int>> v;
+  for(int i = 0; i < 100000; ++i) {
+    v.push_back(i);
+  }
+  REQUIRE(v[99999] == 99999);
+
+  auto copy = v;
+  REQUIRE(copy == v);
+}
+
+TEST_CASE("huge page vectors grow in place") {
+  huge_page_vector<int> v;
+  v.resize(10);
+  REQUIRE(v.size() == 10);
+  REQUIRE(v[9] == 0);
+  v[3] = 3;
+
+  SECTION("growth keeps existing contents") {
+    v.resize(4 << 20);
+    REQUIRE(v[3] == 3);
+    REQUIRE(v[(4 << 20) - 1] == 0);
+    REQUIRE(v.capacity() >= v.size());
+  }
+
+  SECTION("copies are deep") {
+    auto copy = v;
+    copy[3] = 4;
+    REQUIRE(v[3] == 3);
+    REQUIRE_FALSE(copy == v);
+  }
+
+  SECTION("at checks bounds") {
+    REQUIRE_THROWS_AS(v.at(10), std::out_of_range);
+  }
+}
+
+TEST_CASE("huge page stores behave like vector stores") {
+  world<huge_page_store<int>, vector_store<float>> w;
+  for(int i = 0; i < 1000; ++i) {
+    w.addComponent(w.newEntity(), i);
+  }
+
+  mapEntities<int>(w, [](int i) -> std::optional<int> {
+    if(i % 2 == 0) {
+      return std::nullopt;
+    }
+    return i * 2;
+  });
+
+  REQUIRE(w.hasComponent<int>(2) == false);
+  REQUIRE(w.getSafe<int>(3) == 6);
+  REQUIRE(w == decltype(w){w});
+}
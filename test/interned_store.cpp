@@ -0,0 +1,103 @@
+#include "fecs/interned_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace fecs;
+
+using InternedWorld = world<vector_store<int>, interned_store<std::string>>;
+
+static_assert(concepts::GetUnsafeContainer<InternedWorld, std::string>);
+static_assert(concepts::MapResultContainer<std::optional<std::string>, InternedWorld>);
+
+TEST_CASE("interned stores share equal values") {
+  InternedWorld w;
+  for(int i = 0; i < 1000; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    w.addComponent(e, std::string{i % 2 == 0 ? "stone" : "wood"});
+  }
+
+  const auto& store = w.store<std::string>();
+  REQUIRE(store.uniqueCount() == 2);
+  REQUIRE(&store.getUnsafe(0) == &store.getUnsafe(2));
+  REQUIRE(w.getSafe<std::string>(3) == "wood");
+
+  SECTION("mapping re-interns results") {
+    mapEntities<int, std::string>(w, [](int i, const std::string& s) -> std::optional<std::string> {
+      if(i < 500) {
+        return std::nullopt;
+      }
+      return s + "!";
+    });
+    REQUIRE(store.uniqueCount() == 2);
+    REQUIRE(w.hasComponent<std::string>(0) == false);
+    REQUIRE(w.getSafe<std::string>(501) == "wood!");
+  }
+
+  SECTION("unused values leave the pool") {
+    mapEntities<std::string>(w, [](const std::string&) -> std::string { return "glass"; });
+    REQUIRE(store.uniqueCount() == 1);
+    REQUIRE(store.memoryUsage().occupiedSlots == 1000);
+  }
+
+  SECTION("equality compares values, not pool layout") {
+    InternedWorld other;
+    for(int i = 999; i >= 0; --i) {
+      other.newEntity();
+    }
+    for(int i = 999; i >= 0; --i) {
+      other.addComponent(static_cast<EntityId>(i), i);
+      other.addComponent(static_cast<EntityId>(i), std::string{i % 2 == 0 ? "stone" : "wood"});
+    }
+    REQUIRE(other == w);
+  }
+}
+
+TEST_CASE("interned values are stored once and destroyed on release") {
+  interned_store<std::shared_ptr<int>> store;
+  auto value = std::make_shared<int>(1);
+  store.addComponent(0, value);
+  store.addComponent(1, value);
+  // The pool holds the only copy; the hash-cons table just points into it.
+  REQUIRE(value.use_count() == 2);
+
+  store.removeComponent(0);
+  REQUIRE(value.use_count() == 2);
+  store.addComponent(1, std::make_shared<int>(2));
+  REQUIRE(value.use_count() == 1);
+  REQUIRE(*store.getUnsafe(1) == 2);
+}
+
+TEST_CASE("interning survives heavy churn") {
+  interned_store<int> store;
+  std::vector<std::optional<int>> expected(500);
+  std::uint32_t seed = 99;
+  for(int step = 0; step < 20000; ++step) {
+    seed = seed * 1664525u + 1013904223u;
+    const EntityId id = (seed >> 8) % expected.size();
+    if((seed >> 20) % 4 == 0) {
+      store.removeComponent(id);
+      expected[id] = std::nullopt;
+    }
+    else {
+      const int value = static_cast<int>((seed >> 12) % 300);
+      store.addComponent(id, value);
+      expected[id] = value;
+    }
+  }
+  std::vector<int> distinct;
+  for(EntityId id = 0; id < expected.size(); ++id) {
+    REQUIRE(store.getSafe(id) == expected[id]);
+    if(expected[id]) {
+      distinct.push_back(*expected[id]);
+    }
+  }
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+  REQUIRE(store.uniqueCount() == distinct.size());
+  REQUIRE(store.memoryUsage().liveBytes == distinct.size() * sizeof(int));
+}
@@ -0,0 +1,114 @@
+#include "fecs/ordered_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <functional>
+
+using namespace fecs;
+
+using OrderedWorld = world<ordered_store<int>, vector_store<char>>;
+
+static_assert(concepts::MapResultContainer<std::optional<int>, OrderedWorld>);
+static_assert(concepts::DiffContainer<ordered_store<int>>);
+
+TEST_CASE("ordered stores keep their index in sync") {
+  ordered_store<int> store;
+  for(EntityId i = 0; i < 10; ++i) {
+    store.addComponent(i, static_cast<int>((i * 7) % 10));
+  }
+  // Values by id: 0 7 4 1 8 5 2 9 6 3
+
+  REQUIRE(store.idsInRange(2, 5) == std::vector<EntityId>{6, 9, 2});
+  REQUIRE(store.lowest(3) == std::vector<EntityId>{0, 3, 6});
+  REQUIRE(store.highest(2) == std::vector<EntityId>{7, 4});
+
+  SECTION("replacing a value moves it in the index") {
+    store.addComponent(7, -1);
+    REQUIRE(store.lowest(1) == std::vector<EntityId>{7});
+    REQUIRE(store.highest(1) == std::vector<EntityId>{4});
+    REQUIRE(store.size() == 10);
+  }
+
+  SECTION("removing drops it from the index") {
+    store.removeComponent(6);
+    REQUIRE(store.idsInRange(2, 5) == std::vector<EntityId>{9, 2});
+    REQUIRE(store.size() == 9);
+  }
+
+  SECTION("ties are ordered by id") {
+    store.addComponent(1, 4);
+    REQUIRE(store.idsInRange(4, 5) == std::vector<EntityId>{1, 2});
+  }
+
+  SECTION("custom orderings") {
+    ordered_store<int, std::greater<int>> descending;
+    descending.addComponent(0, 1);
+    descending.addComponent(1, 3);
+    REQUIRE(descending.lowest(1) == std::vector<EntityId>{1});
+  }
+}
+
+namespace {
+  struct Score {
+    int points;
+    char name;
+
+    bool operator==(const Score&) const = default;
+  };
+
+  struct by_points {
+    bool operator()(const Score& a, const Score& b) const { return a.points < b.points; }
+  };
+}
+
+TEST_CASE("ordered stores never hand out stale values") {
+  ordered_store<Score, by_points> store;
+  store.addComponent(0, Score{5, 'a'});
+  store.addComponent(1, Score{3, 'b'});
+
+  SECTION("replacing a value with an equivalent one") {
+    store.addComponent(0, Score{5, 'z'});
+    std::vector<char> names;
+    store.forEachInRange(Score{0, ' '}, Score{10, ' '}, [&](EntityId, const Score& s) { names.push_back(s.name); });
+    REQUIRE(names == std::vector<char>{'b', 'z'});
+  }
+
+  SECTION("copies and moves keep a working index") {
+    auto copy = store;
+    copy.addComponent(2, Score{4, 'c'});
+    REQUIRE(copy.lowest(3) == std::vector<EntityId>{1, 2, 0});
+    REQUIRE(store.lowest(3) == std::vector<EntityId>{1, 0});
+
+    auto moved = std::move(copy);
+    moved.addComponent(3, Score{1, 'd'});
+    REQUIRE(moved.lowest(4) == std::vector<EntityId>{3, 1, 2, 0});
+
+    store = moved;
+    store.removeComponent(2);
+    REQUIRE(store.lowest(4) == std::vector<EntityId>{3, 1, 0});
+    REQUIRE(moved.size() == 4);
+  }
+}
+
+TEST_CASE("mapping over a range of values") {
+  OrderedWorld w;
+  for(int i = 0; i < 100; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 2 == 0) {
+      w.addComponent(e, 'x');
+    }
+  }
+
+  int visited = 0;
+  mapEntitiesWhere<int, char>(w, 10, 20, [&](int, char) { ++visited; });
+  REQUIRE(visited == 5);
+
+  // Healing everyone below 10 moves them out of the range, but each is still visited once.
+  mapEntitiesWhere<int>(w, 0, 10, [](int health) { return health + 5; });
+  for(EntityId i = 0; i < 10; ++i) {
+    REQUIRE(w.getUnsafe<int>(i) == static_cast<int>(i) + 5);
+  }
+  REQUIRE(w.store<int>().idsInRange(0, 5).empty());
+  REQUIRE(w.getUnsafe<int>(10) == 10);
+}
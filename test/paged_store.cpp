@@ -0,0 +1,61 @@
+#include "fecs/paged_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/diff.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+static_assert(concepts::GetUnsafeContainer<paged_store<int>, int>);
+static_assert(concepts::DiffContainer<paged_store<int>>);
+static_assert(concepts::MapResultContainer<std::optional<int>, world<paged_store<int>>>);
+
+TEST_CASE("paged stores only allocate touched pages") {
+  paged_store<int, 64> store;
+  store.resizeToFit(100000);
+  REQUIRE(store.memoryUsage().slots == 0);
+
+  store.addComponent(70000, 1);
+  REQUIRE(store.memoryUsage().slots == 64);
+  REQUIRE(store.memoryUsage().occupiedSlots == 1);
+  REQUIRE(store.getUnsafe(70000) == 1);
+  REQUIRE(store.hasComponent(70001) == false);
+
+  SECTION("references stay put while the store grows") {
+    const int *address = &store.getUnsafe(70000);
+    for(EntityId id = 0; id < 200000; id += 50) {
+      store.addComponent(id + 1, 2);
+    }
+    REQUIRE(&store.getUnsafe(70000) == address);
+  }
+
+  SECTION("empty pages are freed") {
+    store.removeComponent(70000);
+    REQUIRE(store.memoryUsage().slots == 0);
+    REQUIRE(store.hasComponent(70000) == false);
+  }
+
+  SECTION("copies are deep") {
+    auto copy = store;
+    copy.addComponent(70000, 2);
+    REQUIRE(store.getUnsafe(70000) == 1);
+    REQUIRE_FALSE(copy == store);
+  }
+}
+
+TEST_CASE("paged stores in a world") {
+  using PagedWorld = world<paged_store<int>, vector_store<float>>;
+  PagedWorld w;
+  for(int i = 0; i < 3000; ++i) {
+    const auto e = w.newEntity();
+    if(i % 1000 == 0) {
+      w.addComponent(e, i);
+    }
+  }
+
+  auto before = w;
+  mapEntities<int>(w, [](int i) -> int { return i + 1; });
+
+  REQUIRE(w.getSafe<int>(2000) == 2001);
+  REQUIRE(diff(before, w).size() == 3);
+}
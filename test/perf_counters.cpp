@@ -0,0 +1,33 @@
+#include "fecs/perf_counters.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+TEST_CASE("perf counters") {
+  auto& counters = perf_counters::forThisThread();
+
+  counters.start();
+  volatile int sum = 0;
+  for(int i = 0; i < 100000; ++i) {
+    sum = sum + i;
+  }
+  const auto result = counters.stop();
+
+  // Perf events are often not permitted in containers and CI, so only check readings we actually got.
+  if(counters.available()) {
+    REQUIRE(result.instructions.value_or(1) > 0);
+  }
+  else {
+    REQUIRE(result == hardware_counters{});
+  }
+}
+
+TEST_CASE("adding counters keeps missing readings empty") {
+  hardware_counters total;
+  total += hardware_counters{.cycles = 10};
+  total += hardware_counters{.cycles = 5, .branchMisses = 2};
+
+  REQUIRE(total.cycles == 15);
+  REQUIRE(total.branchMisses == 2);
+  REQUIRE(total.instructions == std::nullopt);
+}
@@ -0,0 +1,124 @@
+#include "fecs/profile.hpp"
+#include "fecs/world.hpp"
+#include "fecs/vector_store.hpp"
+#include "catch.hpp"
+#include <sstream>
+#include <string>
+#include <tuple>
+
+using namespace fecs;
+
+using ProfiledWorld = world<vector_store<int>, vector_store<float>>;
+
+namespace {
+  ProfiledWorld makeWorld() {
+    ProfiledWorld w;
+    for(int i = 0; i < 10; ++i) {
+      const auto e = w.newEntity();
+      w.addComponent(e, i);
+      if(i % 2 == 0) {
+        w.addComponent(e, static_cast<float>(i));
+      }
+    }
+    return w;
+  }
+}
+
+// Profiling is a build-wide option, so this drives the scope a named mapEntities would use directly.
+TEST_CASE("profile scopes record statistics") {
+  auto& p = profiler::instance();
+  p.reset();
+
+  auto w = makeWorld();
+  auto sum = [](int i, float f) -> int { return i + static_cast<int>(f); };
+  auto print = [](int) -> void {};
+  {
+    detail::profile_scope scope{"sum"};
+    detail::mapEntitiesLoop<int, float>(w, sum, scope.stats);
+  }
+  for(int i = 0; i < 2; ++i) {
+    detail::profile_scope scope{"print"};
+    detail::mapEntitiesVoidLoop<int>(w, print, scope.stats);
+  }
+
+  const auto totals = p.totals();
+  REQUIRE(totals.size() == 2);
+
+  const auto& sumTotals = totals.at("sum");
+  REQUIRE(sumTotals.calls == 1);
+  REQUIRE(sumTotals.stats.visited == w.maxId());
+  REQUIRE(sumTotals.stats.matched == 5);
+  REQUIRE(sumTotals.stats.written == 5);
+
+  const auto& printTotals = totals.at("print");
+  REQUIRE(printTotals.calls == 2);
+  REQUIRE(printTotals.stats.matched == 20);
+  REQUIRE(printTotals.stats.written == 0);
+
+  std::ostringstream trace;
+  p.writeChromeTrace(trace);
+  REQUIRE(trace.str().starts_with("{\"traceEvents\":[{\"name\":\"sum\""));
+  REQUIRE(trace.str().find("\"matched\":10") != std::string::npos);
+  REQUIRE(trace.str().find("\"written\":5") != std::string::npos);
+
+  std::ostringstream drained;
+  p.writeChromeTrace(drained);
+  REQUIRE(drained.str() == "{\"traceEvents\":[]}");
+  REQUIRE(p.totals().at("sum").calls == 1);
+}
+
+TEST_CASE("written counts the components results assign") {
+  auto& p = profiler::instance();
+  p.reset();
+
+  auto w = makeWorld();
+  // Odd ids lose their int; even ids get a new int and float.
+  auto split = [](int i) -> std::tuple<std::optional<int>, std::optional<float>> {
+    if(i % 2 != 0) {
+      return {std::nullopt, std::nullopt};
+    }
+    return {i, static_cast<float>(i)};
+  };
+  {
+    detail::profile_scope scope{"split"};
+    detail::mapEntitiesLoop<int>(w, split, scope.stats);
+  }
+  const auto stats = p.totals().at("split").stats;
+  REQUIRE(stats.matched == 10);
+  REQUIRE(stats.written == 10);
+}
+
+TEST_CASE("trace events keep their names and are capped") {
+  auto& p = profiler::instance();
+  p.reset();
+  p.setEventLimit(2);
+
+  for(int i = 0; i < 3; ++i) {
+    // The name is a temporary, gone by the time the trace is written.
+    p.record(std::string("system" + std::to_string(i)).c_str(), profiler::clock::now(), profiler::clock::now(), {});
+  }
+  std::ostringstream trace;
+  p.writeChromeTrace(trace);
+  REQUIRE(trace.str().find("system0") == std::string::npos);
+  REQUIRE(trace.str().find("\"name\":\"system1\"") != std::string::npos);
+  REQUIRE(trace.str().find("\"name\":\"system2\"") != std::string::npos);
+  REQUIRE(p.totals().size() == 3);
+
+  p.setEventLimit(65536);
+  p.reset();
+}
+
+TEST_CASE("named mapping is only recorded in profiling builds") {
+  auto& p = profiler::instance();
+  p.reset();
+
+  auto w = makeWorld();
+  mapEntities<int>(w, "increment", [](int i) -> int { return i + 1; });
+  REQUIRE(w.getUnsafe<int>(9) == 10);
+
+#ifdef FECS_ENABLE_PROFILING
+  REQUIRE(p.totals().at("increment").calls == 1);
+#else
+  REQUIRE(p.totals().empty());
+#endif
+}
@@ -0,0 +1,104 @@
+#include "fecs/reduce.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <stdexcept>
+
+using namespace fecs;
+
+namespace {
+  struct Box {
+    float minX;
+    float maxX;
+  };
+}
+
+using ReduceWorld = world<vector_store<int>, vector_store<float>>;
+
+TEST_CASE("reductions over many chunks") {
+  ReduceWorld w;
+  constexpr int size = 60000;
+  for(int i = 0; i < size; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 3 == 0) {
+      w.addComponent(e, static_cast<float>(i % 1000) - 500.0f);
+    }
+  }
+
+  REQUIRE(count<int>(w) == size);
+  REQUIRE(count<int, float>(w) == (size + 2) / 3);
+  REQUIRE(sum<int>(w) == size / 2 * (size - 1));
+  REQUIRE(minimum<int>(w) == 0);
+  REQUIRE(maximum<int>(w) == size - 1);
+  REQUIRE(minimum<float>(w) == -500.0f);
+
+  SECTION("custom accumulators") {
+    const auto box = reduce<float>(
+        w,
+        Box{1e9f, -1e9f},
+        [](Box b, float x) { return Box{std::min(b.minX, x), std::max(b.maxX, x)}; },
+        [](Box a, Box b) { return Box{std::min(a.minX, b.minX), std::max(a.maxX, b.maxX)}; }
+    );
+    REQUIRE(box.minX == -500.0f);
+    REQUIRE(box.maxX == 499.0f);
+  }
+
+  SECTION("floating point sums are repeatable") {
+    const auto first = sum<float>(w);
+    for(int i = 0; i < 5; ++i) {
+      REQUIRE(sum<float>(w) == first);
+    }
+  }
+
+  SECTION("exceptions reach the caller") {
+    auto throwing = [](int acc, int i) {
+      if(i == size / 2) {
+        throw std::runtime_error("bad entity");
+      }
+      return acc + 1;
+    };
+    REQUIRE_THROWS_AS(reduce<int>(w, 0, throwing, std::plus<>{}), std::runtime_error);
+  }
+}
+
+TEST_CASE("reductions over empty worlds") {
+  ReduceWorld w;
+  REQUIRE(count<int>(w) == 0);
+  REQUIRE(sum<int>(w) == 0);
+  REQUIRE(maximum<int>(w) == std::nullopt);
+}
+
+namespace {
+  struct Team {
+    int id;
+
+    bool operator==(const Team&) const = default;
+  };
+}
+
+template<>
+struct std::hash<Team> {
+  std::size_t operator()(const Team& t) const { return std::hash<int>{}(t.id); }
+};
+
+TEST_CASE("grouped reductions") {
+  world<vector_store<Team>, vector_store<int>> w;
+  constexpr int size = 50000;
+  for(int i = 0; i < size; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, 1);
+    if(i % 10 != 0) {
+      w.addComponent(e, Team{i % 4});
+    }
+  }
+
+  const auto perTeam = groupBy<Team, int>(w, 0, [](int acc, int damage) { return acc + damage; }, std::plus<>{});
+  REQUIRE(perTeam.size() == 4);
+  REQUIRE(perTeam.at(Team{1}) == size / 4);
+  REQUIRE(perTeam.at(Team{0}) == size / 4 - size / 20);
+  REQUIRE(perTeam.at(Team{2}) == size / 4 - size / 20);
+
+  const auto members = groupBy<Team>(w, 0, [](int acc) { return acc + 1; }, std::plus<>{});
+  REQUIRE(members == perTeam);
+}
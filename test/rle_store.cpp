@@ -0,0 +1,111 @@
+#include "fecs/rle_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/diff.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+using RleWorld = world<vector_store<int>, rle_store<char>>;
+
+static_assert(concepts::MapResultContainer<std::optional<char>, RleWorld>);
+static_assert(concepts::DiffContainer<rle_store<char>>);
+
+TEST_CASE("rle stores merge equal neighbours") {
+  rle_store<char> store;
+  for(EntityId i = 0; i < 100; ++i) {
+    store.addComponent(i, i < 60 ? 'a' : 'b');
+  }
+  REQUIRE(store.allRuns().size() == 2);
+  REQUIRE(store.getUnsafe(59) == 'a');
+  REQUIRE(store.getUnsafe(60) == 'b');
+  REQUIRE(store.hasComponent(100) == false);
+
+  SECTION("writing inside a run splits it") {
+    store.addComponent(10, 'c');
+    REQUIRE(store.allRuns().size() == 4);
+    REQUIRE(store.getSafe(9) == 'a');
+    REQUIRE(store.getSafe(10) == 'c');
+    REQUIRE(store.getSafe(11) == 'a');
+
+    store.addComponent(10, 'a');
+    REQUIRE(store.allRuns().size() == 2);
+  }
+
+  SECTION("removing leaves a gap") {
+    store.setRange(50, 20, std::nullopt);
+    REQUIRE(store.allRuns().size() == 2);
+    REQUIRE(store.hasComponent(55) == false);
+    REQUIRE(store.getSafe(70) == 'b');
+  }
+
+  SECTION("diffs report each differing id") {
+    auto other = store;
+    other.setRange(58, 4, 'z');
+    std::vector<EntityId> ids;
+    store.forEachDifference(other, [&](EntityId id) { ids.push_back(id); });
+    REQUIRE(ids == std::vector<EntityId>{58, 59, 60, 61});
+  }
+}
+
+TEST_CASE("rle stores agree with a plain array under random writes") {
+  rle_store<char> store;
+  std::vector<std::optional<char>> expected(200);
+  std::uint32_t seed = 12345;
+  auto next = [&](std::uint32_t bound) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) % bound;
+  };
+  for(int step = 0; step < 5000; ++step) {
+    const EntityId start = next(190);
+    const EntityId length = next(4) == 0 ? 1 + next(10) : 1;
+    const auto value = next(5) == 0 ? std::nullopt : std::optional<char>{static_cast<char>('a' + next(3))};
+    store.setRange(start, length, value);
+    for(auto id = start; id < start + length; ++id) {
+      expected[id] = value;
+    }
+    if(step % 97 == 0 || step == 4999) {
+      for(EntityId id = 0; id < expected.size(); ++id) {
+        REQUIRE(store.getSafe(id) == expected[id]);
+      }
+      // Runs are sorted, disjoint and merged after every write.
+      const auto& runs = store.allRuns();
+      for(std::size_t i = 1; i < runs.size(); ++i) {
+        REQUIRE(runs[i - 1].end() <= runs[i].start);
+        REQUIRE((runs[i - 1].end() != runs[i].start || runs[i - 1].value != runs[i].value));
+      }
+    }
+  }
+}
+
+TEST_CASE("mapping runs") {
+  RleWorld w;
+  for(int i = 0; i < 1000; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    w.addComponent(e, static_cast<char>('a' + i / 250));
+  }
+
+  int calls = 0;
+  mapRuns<char>(w, [&](char c) -> std::optional<char> {
+    ++calls;
+    if(c == 'b') {
+      return std::nullopt;
+    }
+    return static_cast<char>(c + 1);
+  });
+
+  REQUIRE(calls == 4);
+  REQUIRE(w.getSafe<char>(0) == 'b');
+  REQUIRE(w.hasComponent<char>(300) == false);
+  REQUIRE(w.getSafe<char>(999) == 'e');
+
+  int matched = 0;
+  mapEntities<int, char>(w, [&](int, char) -> void { ++matched; });
+  REQUIRE(matched == 750);
+
+  SECTION("runs that end up equal are merged") {
+    mapRuns<char>(w, [](char) -> std::optional<char> { return 'x'; });
+    REQUIRE(w.store<char>().allRuns().size() == 2);
+  }
+}
@@ -0,0 +1,44 @@
+#include "fecs/singleton_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/delta.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+namespace {
+  struct DeltaTime {
+    float seconds = 0;
+    bool operator==(const DeltaTime&) const = default;
+  };
+}
+
+using SingletonWorld = world<vector_store<float>, singleton_store<DeltaTime>>;
+
+static_assert(concepts::GetUnsafeContainer<SingletonWorld, DeltaTime>);
+static_assert(concepts::MapResultContainer<DeltaTime, SingletonWorld>);
+static_assert(!concepts::RemoveContainer<SingletonWorld, DeltaTime>);
+static_assert(!concepts::MapResultContainer<std::optional<DeltaTime>, SingletonWorld>);
+
+TEST_CASE("singleton stores share one value") {
+  SingletonWorld w;
+  for(int i = 0; i < 10; ++i) {
+    w.addComponent(w.newEntity(), static_cast<float>(i));
+  }
+  w.addComponent(0, DeltaTime{0.5f});
+
+  REQUIRE(w.hasComponent<DeltaTime>(7));
+  REQUIRE(w.getUnsafe<DeltaTime>(7).seconds == 0.5f);
+
+  mapEntities<float, DeltaTime>(w, [](float f, DeltaTime dt) -> float { return f + dt.seconds; });
+  REQUIRE(w.getSafe<float>(3) == 3.5f);
+
+  SECTION("changes show up in deltas") {
+    auto after = w;
+    after.addComponent(5, DeltaTime{0.25f});
+    const auto delta = world_delta<SingletonWorld>::between(w, after);
+    REQUIRE(delta.size() == 1);
+    delta.applyTo(w);
+    REQUIRE(w.store<DeltaTime>().get().seconds == 0.25f);
+  }
+}
@@ -0,0 +1,145 @@
+#include "fecs/spatial_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace fecs;
+
+namespace {
+  struct Body {
+    float x;
+    float y;
+
+    bool operator==(const Body&) const = default;
+  };
+
+  float distance2(const Body& a, float x, float y) {
+    return (a.x - x) * (a.x - x) + (a.y - y) * (a.y - y);
+  }
+}
+
+using SpatialWorld = world<spatial_store<Body>, vector_store<int>>;
+
+static_assert(concepts::MapResultContainer<std::optional<Body>, SpatialWorld>);
+static_assert(concepts::DiffContainer<spatial_store<Body>>);
+
+TEST_CASE("spatial stores answer range and nearest queries") {
+  spatial_store<Body> store{4.0f};
+  std::vector<Body> bodies;
+  std::mt19937 rng{7};
+  std::uniform_real_distribution<float> coord{-50.0f, 50.0f};
+  for(EntityId i = 0; i < 500; ++i) {
+    bodies.push_back({coord(rng), coord(rng)});
+    store.addComponent(i, bodies.back());
+  }
+
+  SECTION("range queries match a brute-force scan") {
+    std::vector<EntityId> found;
+    store.forEachInRadius(3.0f, -7.0f, 9.5f, [&](EntityId id, const Body&) { found.push_back(id); });
+    std::vector<EntityId> expected;
+    for(EntityId i = 0; i < bodies.size(); ++i) {
+      if(distance2(bodies[i], 3.0f, -7.0f) <= 9.5f * 9.5f) {
+        expected.push_back(i);
+      }
+    }
+    std::sort(found.begin(), found.end());
+    REQUIRE(!expected.empty());
+    REQUIRE(found == expected);
+  }
+
+  SECTION("nearest matches a brute-force scan") {
+    for(int q = 0; q < 50; ++q) {
+      const auto x = coord(rng) * 1.5f;
+      const auto y = coord(rng) * 1.5f;
+      const auto best = std::min_element(bodies.begin(), bodies.end(), [&](const Body& a, const Body& b) {
+        return distance2(a, x, y) < distance2(b, x, y);
+      });
+      const auto id = store.nearest(x, y);
+      REQUIRE(id.has_value());
+      REQUIRE(distance2(bodies[*id], x, y) == distance2(*best, x, y));
+    }
+  }
+
+  SECTION("nearest can skip the asking entity and respects the limit") {
+    const auto other = store.nearest(bodies[0].x, bodies[0].y, 1000.0f, 0);
+    REQUIRE(other.has_value());
+    REQUIRE(*other != 0);
+    REQUIRE(store.nearest(1000.0f, 1000.0f, 10.0f) == std::nullopt);
+  }
+
+  SECTION("moving and removing keep the grid up to date") {
+    store.addComponent(0, Body{200.0f, 200.0f});
+    REQUIRE(store.nearest(201.0f, 199.0f) == 0);
+    store.removeComponent(0);
+    REQUIRE(store.nearest(201.0f, 199.0f) != 0);
+    int count = 0;
+    store.forEachInRadius(200.0f, 200.0f, 5.0f, [&](EntityId, const Body&) { ++count; });
+    REQUIRE(count == 0);
+  }
+
+  SECTION("copies compare by content") {
+    auto copy = store;
+    REQUIRE(copy == store);
+    copy.addComponent(3, Body{0.0f, 0.0f});
+    std::vector<EntityId> ids;
+    store.forEachDifference(copy, [&](EntityId id) { ids.push_back(id); });
+    REQUIRE(ids == std::vector<EntityId>{3});
+  }
+}
+
+TEST_CASE("spatial stores handle far away and invalid positions") {
+  spatial_store<Body> store{1.0f};
+  store.addComponent(0, Body{0.0f, 0.0f});
+  store.addComponent(1, Body{1.0e6f, -1.0e6f});
+
+  SECTION("nearest finds a lone far away component without walking every ring") {
+    REQUIRE(store.nearest(2.0e6f, -2.0e6f) == 1);
+    REQUIRE(store.nearest(0.5f, 0.5f, std::numeric_limits<float>::infinity(), 0) == 1);
+  }
+
+  SECTION("huge radii scan the occupied cells") {
+    int count = 0;
+    store.forEachInRadius(0.0f, 0.0f, 1.0e7f, [&](EntityId, const Body&) { ++count; });
+    REQUIRE(count == 2);
+  }
+
+  SECTION("positions past the grid clamp to its edge cells") {
+    store.addComponent(2, Body{1.0e20f, -1.0e20f});
+    store.addComponent(3, Body{std::numeric_limits<float>::infinity(), 0.0f});
+    REQUIRE(store.nearest(1.0e20f, -1.0e20f, 1.0f) == 2);
+    REQUIRE(store.hasComponent(3));
+    int count = 0;
+    store.forEachInRadius(0.0f, 0.0f, 10.0f, [&](EntityId, const Body&) { ++count; });
+    REQUIRE(count == 1);
+  }
+
+  SECTION("NaN positions are rejected") {
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE_THROWS_AS(store.addComponent(2, Body{nan, 0.0f}), std::invalid_argument);
+    REQUIRE(store.hasComponent(2) == false);
+    REQUIRE(store.nearest(nan, 0.0f) == std::nullopt);
+  }
+}
+
+TEST_CASE("systems can query the spatial store") {
+  SpatialWorld w;
+  for(int i = 0; i < 10; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, Body{static_cast<float>(i), 0.0f});
+    w.addComponent(e, 0);
+  }
+
+  // Count the neighbours within 1.5 units, which is everyone but the two ends of the line.
+  const auto& bodies = w.store<Body>();
+  mapEntities<Body, int>(w, [&](const Body& b, int) -> int {
+    int neighbours = -1;
+    bodies.forEachInRadius(b.x, b.y, 1.5f, [&](EntityId, const Body&) { ++neighbours; });
+    return neighbours;
+  });
+  REQUIRE(w.getUnsafe<int>(0) == 1);
+  REQUIRE(w.getUnsafe<int>(5) == 2);
+  REQUIRE(w.getUnsafe<int>(9) == 1);
+}
@@ -0,0 +1,59 @@
+#include "fecs/tag_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+namespace {
+  struct Enemy {};
+  struct Dead {};
+}
+
+using TagWorld = world<vector_store<int>, tag_store<Enemy>, tag_store<Dead>>;
+
+static_assert(concepts::GetUnsafeContainer<TagWorld, Enemy>);
+static_assert(concepts::MapResultContainer<std::optional<Dead>, TagWorld>);
+static_assert(concepts::PresenceMaskContainer<tag_store<Enemy>, Enemy>);
+
+TEST_CASE("tag stores") {
+  TagWorld w;
+  for(int i = 0; i < 200; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, i);
+    if(i % 2 == 0) {
+      w.addComponent(e, Enemy{});
+    }
+    if(i % 3 == 0) {
+      w.addComponent(e, Dead{});
+    }
+  }
+
+  SECTION("filtering on tags") {
+    int count = 0;
+    mapEntities<int, Enemy, Dead>(w, [&](int i, Enemy, Dead) -> void {
+      REQUIRE(i % 6 == 0);
+      ++count;
+    });
+    REQUIRE(count == 34);
+  }
+
+  SECTION("tags intersect a word at a time") {
+    const auto both = w.presenceWord<Enemy, Dead>(1);
+    for(int b = 0; b < 64; ++b) {
+      REQUIRE(((both >> b) & 1u) == ((64 + b) % 6 == 0));
+    }
+  }
+
+  SECTION("mapping can remove tags") {
+    mapEntities<int, Dead>(w, [](int, Dead) -> std::optional<Dead> { return std::nullopt; });
+    REQUIRE(w.store<Dead>().count() == 0);
+    REQUIRE(w.store<Enemy>().count() == 100);
+  }
+
+  SECTION("one bit per entity") {
+    const auto usage = w.store<Enemy>().memoryUsage();
+    REQUIRE(usage.allocatedBytes < 200);
+    REQUIRE(usage.occupiedSlots == 100);
+  }
+}
@@ -0,0 +1,111 @@
+#include "fecs/timer_store.hpp"
+#include "fecs/vector_store.hpp"
+#include "fecs/world.hpp"
+#include "catch.hpp"
+
+using namespace fecs;
+
+namespace {
+  struct RespawnAt {
+    int time;
+
+    bool operator==(const RespawnAt&) const = default;
+  };
+}
+
+using TimerWorld = world<timer_store<RespawnAt>, vector_store<int>>;
+
+static_assert(concepts::MapResultContainer<std::optional<RespawnAt>, TimerWorld>);
+static_assert(concepts::DiffContainer<timer_store<RespawnAt>>);
+
+TEST_CASE("timer stores find expired deadlines") {
+  timer_store<RespawnAt> store;
+  for(EntityId i = 0; i < 10; ++i) {
+    store.addComponent(i, RespawnAt{static_cast<int>(10 - i)});
+  }
+  // Deadlines by id: 10 9 8 7 6 5 4 3 2 1
+
+  REQUIRE(store.expired(0).empty());
+  REQUIRE(store.expired(3) == std::vector<EntityId>{9, 8, 7});
+  REQUIRE(store.nextDeadline() == 1);
+
+  SECTION("replacing a component reschedules it") {
+    store.addComponent(9, RespawnAt{20});
+    store.addComponent(0, RespawnAt{1});
+    REQUIRE(store.expired(3) == std::vector<EntityId>{0, 8, 7});
+    REQUIRE(store.nextDeadline() == 1);
+  }
+
+  SECTION("removed components never expire") {
+    store.removeComponent(9);
+    store.removeComponent(8);
+    REQUIRE(store.expired(3) == std::vector<EntityId>{7});
+    REQUIRE(store.nextDeadline() == 3);
+  }
+
+  SECTION("ties are ordered by id") {
+    store.addComponent(2, RespawnAt{1});
+    REQUIRE(store.expired(1) == std::vector<EntityId>{2, 9});
+  }
+
+  SECTION("heavy churn compacts the heap without losing anything") {
+    for(int round = 0; round < 1000; ++round) {
+      store.addComponent(round % 10, RespawnAt{100 + round});
+    }
+    REQUIRE(store.expired(1099).size() == 10);
+    REQUIRE(store.expired(1098).size() == 9);
+    REQUIRE(store.memoryUsage().allocatedBytes < 10000);
+  }
+}
+
+TEST_CASE("mapping expired components") {
+  TimerWorld w;
+  for(int i = 0; i < 100; ++i) {
+    const auto e = w.newEntity();
+    w.addComponent(e, RespawnAt{i});
+    w.addComponent(e, 0);
+  }
+
+  int visited = 0;
+  mapExpired<RespawnAt>(w, 9, [&](const RespawnAt&) { ++visited; });
+  REQUIRE(visited == 10);
+
+  // Respawn everyone due, which removes their timer.
+  mapExpired<RespawnAt, int>(w, 9, [](const RespawnAt&, int lives) {
+    return std::make_tuple(lives + 1, std::optional<RespawnAt>{});
+  });
+  REQUIRE(w.getUnsafe<int>(9) == 1);
+  REQUIRE(w.getUnsafe<int>(10) == 0);
+  REQUIRE(w.store<RespawnAt>().expired(9).empty());
+  REQUIRE(w.store<RespawnAt>().nextDeadline() == 10);
+}
+
+TEST_CASE("consuming expired timers keeps the heap small") {
+  timer_store<RespawnAt> store;
+  constexpr int timers = 20000;
+  for(EntityId i = 0; i < timers; ++i) {
+    store.addComponent(i, RespawnAt{static_cast<int>(i / 100)});
+  }
+
+  // Every frame, the 100 due timers are pushed far into the future.
+  for(int frame = 0; frame < 1000; ++frame) {
+    std::size_t due = 0;
+    store.consumeExpired(frame, [&](EntityId id) {
+      ++due;
+      store.addComponent(id, RespawnAt{frame + 200});
+    });
+    REQUIRE(due == 100);
+    REQUIRE(store.scheduledEntries() == timers);
+    REQUIRE(store.expired(frame).empty());
+  }
+
+  SECTION("untouched timers stay expired") {
+    std::vector<EntityId> first;
+    store.consumeExpired(1000, [&](EntityId id) { first.push_back(id); });
+    std::vector<EntityId> second;
+    store.consumeExpired(1000, [&](EntityId id) { second.push_back(id); });
+    REQUIRE(first.size() == 100);
+    REQUIRE(first == second);
+    REQUIRE(store.expired(1000) == first);
+  }
+}
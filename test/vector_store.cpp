@@ -42,3 +42,62 @@ TEST_CASE("operations on singular stores") {
     REQUIRE(storage.hasComponent(0) == false);
   }
 }
+
+TEST_CASE("comparing stores") {
+  vector_store<int> a;
+  vector_store<int> b;
+  a.addComponent(0, 10);
+  b.addComponent(0, 10);
+
+  SECTION("trailing empty slots do not matter") {
+    b.resizeToFit(100);
+    REQUIRE(a == b);
+    REQUIRE(std::is_eq(a <=> b));
+  }
+
+  SECTION("ordering agrees with equality") {
+    b.addComponent(3, 1);
+    b.removeComponent(3);
+    REQUIRE(a == b);
+    REQUIRE(std::is_eq(a <=> b));
+
+    b.addComponent(1, 5);
+    REQUIRE(a < b);
+    a.addComponent(1, 6);
+    REQUIRE(b < a);
+  }
+
+  SECTION("forEachDifference finds slots past the end of the other store") {
+    b.addComponent(5000, 1);
+    std::vector<EntityId> ids;
+    a.forEachDifference(b, [&](EntityId id) { ids.push_back(id); });
+    REQUIRE(ids == std::vector<EntityId>{5000});
+    REQUIRE_FALSE(a == b);
+  }
+
+  SECTION("forEachDifference stops when the visitor returns false") {
+    b.addComponent(1, 1);
+    b.addComponent(2, 2);
+    std::vector<EntityId> ids;
+    const bool finished = a.forEachDifference(b, [&](EntityId id) {
+      ids.push_back(id);
+      return false;
+    });
+    REQUIRE_FALSE(finished);
+    REQUIRE(ids == std::vector<EntityId>{1});
+  }
+}
+
+TEST_CASE("vector store memory usage") {
+  vector_store<int> storage;
+  storage.resizeToFit(9);
+  storage.addComponent(3, 1);
+  storage.addComponent(7, 2);
+
+  const auto usage = storage.memoryUsage();
+  REQUIRE(usage.slots == 10);
+  REQUIRE(usage.occupiedSlots == 2);
+  REQUIRE(usage.liveBytes == 2 * sizeof(int));
+  REQUIRE(usage.allocatedBytes >= 10 * sizeof(std::optional<int>));
+  REQUIRE(usage.overheadBytes() == usage.allocatedBytes - usage.liveBytes);
+}
@@ -2,6 +2,8 @@
 #include "fecs/vector_store.hpp"
 #include "fecs/concepts.hpp"
 #include "catch.hpp"
+#include <sstream>
+#include <vector>
 
 using namespace fecs;
 
@@ -84,3 +86,51 @@ TEST_CASE("mapping while requesting an optional") {
   REQUIRE(w.hasComponent<std::optional<int>>(e));
   REQUIRE(w.hasComponent<int>(e) == false);
 }
+
+TEST_CASE("memory usage per store") {
+  auto [entity, w] = makeWorld();
+  w.removeComponent<float>(entity);
+
+  const auto usage = w.memoryUsage();
+  REQUIRE(usage[0].occupiedSlots == 1);
+  REQUIRE(usage[1].occupiedSlots == 0);
+
+  std::ostringstream report;
+  w.writeMemoryReport(report);
+  REQUIRE(report.str().find("vector_store<float") != std::string::npos);
+  REQUIRE(report.str().find("total: allocated") != std::string::npos);
+}
+
+struct named_positions : vector_store<float> {
+  const char *name() const { return "positions"; }
+};
+
+TEST_CASE("memory report uses store names") {
+  world<vector_store<int>, named_positions> w;
+  const auto e = w.newEntity();
+  w.addComponent(e, 1.0f);
+
+  std::ostringstream report;
+  w.writeMemoryReport(report);
+  REQUIRE(report.str().find("positions: allocated") != std::string::npos);
+  REQUIRE(report.str().find("vector_store<int") != std::string::npos);
+}
+
+TEST_CASE("mapping with the entity id") {
+  TestWorld w;
+  for(int i = 0; i < 5; ++i) {
+    const auto e = w.newEntity();
+    if(i % 2 == 0) {
+      w.addComponent(e, 0);
+    }
+  }
+
+  mapEntities<fecs::entity, int>(w, [](fecs::entity e, int) -> int { return static_cast<int>(e.id) * 10; });
+  REQUIRE(w.getSafe<int>(2) == 20);
+  REQUIRE(w.getSafe<int>(4) == 40);
+  REQUIRE(w.hasComponent<int>(1) == false);
+
+  std::vector<EntityId> seen;
+  mapEntities<int, fecs::entity>(w, [&](int, EntityId id) -> void { seen.push_back(id); });
+  REQUIRE(seen == std::vector<EntityId>{0, 2, 4});
+}